@@ -2,152 +2,383 @@
 
 #include "AggregatedTickFunction.h"
 #include "TickAggregatorInterface.h"
+#include "Async/ParallelFor.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/Script.h"
+#include "UObject/Stack.h"
 
 DECLARE_CYCLE_STAT(TEXT("Tick Aggregator - Remove Objects"), STAT_TickAggregator_RemoveObjects, STATGROUP_TickAggregator);
 
 DECLARE_CYCLE_STAT(TEXT("Tick Aggregator - Total Tick Time"), STAT_TickAggregator_Tick, STATGROUP_TickAggregator);
 DECLARE_CYCLE_STAT(TEXT("Tick Aggregator - Tick Native Functions"), STAT_TickAggregator_TickNativeFunctions, STATGROUP_TickAggregator);
 DECLARE_CYCLE_STAT(TEXT("Tick Aggregator - Tick Blueprint Functions"), STAT_TickAggregator_TickBlueprintFunctions, STATGROUP_TickAggregator);
+DECLARE_CYCLE_STAT(TEXT("Tick Aggregator - Tick Parallel Native Functions"), STAT_TickAggregator_TickParallelNativeFunctions, STATGROUP_TickAggregator);
 
 DECLARE_CYCLE_STAT(TEXT("Tick Aggregator - Tick Unordered Native Functions"), STAT_TickAggregator_TickUnorderedNativeFunctions, STATGROUP_TickAggregator);
 DECLARE_CYCLE_STAT(TEXT("Tick Aggregator - Tick Unordered Blueprint Functions"), STAT_TickAggregator_TickUnorderedBlueprintFunctions, STATGROUP_TickAggregator);
 
+TRACE_DECLARE_INT_COUNTER(TickAggregator_ExecutedFunctions, TEXT("TickAggregator/Executed Functions"));
+TRACE_DECLARE_INT_COUNTER(TickAggregator_AddedFunctions, TEXT("TickAggregator/Added Functions"));
+TRACE_DECLARE_INT_COUNTER(TickAggregator_RemovedFunctions, TEXT("TickAggregator/Removed Functions"));
+
+#if TICK_AGGREGATOR_TRACE_ENABLED
+UE_TRACE_CHANNEL_DEFINE(TickAggregatorChannel);
+#endif
+
 // Note: TICK_AGGREGATOR_DO_CHECKS is only valid in editor.
 
-void FAggregatedTickFunctionCollection::TickObjects(float DeltaTime)
+namespace Intax::TA::Private
+{
+	/** Location that LOD of given tick function owner is evaluated with. Returns false if object isn't placed in world. */
+	static bool GetTickObjectLocation(const UObject* Object, FVector& OutLocation)
+	{
+		if (const AActor* Actor = Cast<AActor>(Object))
+		{
+			OutLocation = Actor->GetActorLocation();
+			return true;
+		}
+
+		if (const USceneComponent* SceneComponent = Cast<USceneComponent>(Object))
+		{
+			OutLocation = SceneComponent->GetComponentLocation();
+			return true;
+		}
+
+		if (const UActorComponent* ActorComponent = Cast<UActorComponent>(Object))
+		{
+			if (const AActor* Owner = ActorComponent->GetOwner())
+			{
+				OutLocation = Owner->GetActorLocation();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/** Removes objects that are about to be collected from given set of raw pointers. */
+	static void RemoveUnreachableObjects(TSet<UObject*>& Objects)
+	{
+		for (TSet<UObject*>::TIterator It = Objects.CreateIterator(); It; ++It)
+		{
+			if ((*It)->IsUnreachable())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
+void FAggregatedTickFunctionCollection::TickObjects(float DeltaTime, const FTickAggregatorFrameContext& FrameContext)
 {
 	SCOPE_CYCLE_COUNTER(STAT_TickAggregator_Tick);
 
 	// for each native array that is sorted by class type...
-	for (const FTickAggregatorNativeObjectArray& NativeObjectArray : RegisteredNativeObjectsArray)
+	// a tick function might register a new class or a new group, which reallocates the arrays below. so arrays aren't referenced
+	// across ticks, they're fetched by their indices again after each group ticked. groups are heap allocated, so the group
+	// that is ticking stays where it is.
+	for (int32 ActiveIndex = 0; ActiveIndex < ActiveNativeObjectArrays.Num(); ++ActiveIndex)
 	{
+		const int32 ClassIndex = ActiveNativeObjectArrays[ActiveIndex];
+
 		SCOPE_CYCLE_COUNTER(STAT_TickAggregator_TickNativeFunctions);
+		TA_TRACE_SCOPE(RegisteredNativeObjectsArray[ClassIndex].GetTraceName());
+
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+		FScopeCycleCounter ClassCycleCounter(RegisteredNativeObjectsArray[ClassIndex].GetStats().CycleStatId);
+		int32 ClassExecutedCount = 0;
+#endif
 
 		// for each tick group that is sorted by identity...
-		const TArray<FTickFunctionGroup>& TickFunctionGroupArray = NativeObjectArray.Get();
-		for (const FTickFunctionGroup& TickFunctionGroup : TickFunctionGroupArray)
+		for (int32 GroupIndex = 0; GroupIndex < RegisteredNativeObjectsArray[ClassIndex].Get().Num(); ++GroupIndex)
 		{
-			const TArray<FAggregatedTickDelegate>& TickFunctionArray = TickFunctionGroup.Get();
-
-#if TICK_AGGREGATOR_DO_CHECKS
-			if (!ensureMsgf(!TickFunctionArray.IsEmpty(), TEXT("Given TickFunctionArray was empty, it should have been removed before loop executed.")))
+			FTickFunctionGroup& TickFunctionGroup = RegisteredNativeObjectsArray[ClassIndex].Get()[GroupIndex];
+			if (TickFunctionGroup.Num() == 0)
 			{
 				continue;
 			}
+
+			// invoke the tick function delegates, group decides whether it can go wide or not.
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+			ClassExecutedCount += TickFunctionGroup.Tick(DeltaTime, FrameContext);
+#else
+			TickFunctionGroup.Tick(DeltaTime, FrameContext);
 #endif
+		}
 
-			// get tick function delegates and invoke them.
-			for (const FAggregatedTickDelegate& TickFunctionPtr : TickFunctionArray)
+		// typed groups of the same class, they call their member functions directly. they're never deferred but their time
+		// still counts against the frame budget.
+		if (RegisteredNativeObjectsArray[ClassIndex].GetTypedGroups().Num() > 0)
+		{
+			const uint64 TypedStartCycles = FPlatformTime::Cycles64();
+			for (int32 TypedGroupIndex = 0; TypedGroupIndex < RegisteredNativeObjectsArray[ClassIndex].GetTypedGroups().Num(); ++TypedGroupIndex)
 			{
+				FTypedTickFunctionGroupBase* TypedTickFunctionGroup = RegisteredNativeObjectsArray[ClassIndex].GetTypedGroups()[TypedGroupIndex].Get();
+				TA_TRACE_SCOPE(TypedTickFunctionGroup->GetTraceName());
 
-#if TICK_AGGREGATOR_DO_CHECKS
-					if (!ensureAlwaysMsgf(TickFunctionPtr.IsBound(), TEXT("TickFunctionPtr was not bound to anything?!")))
-					{
-						continue;
-					}
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+				FScopeCycleCounter TypedGroupCycleCounter(TypedTickFunctionGroup->GetStats().CycleStatId);
+				TypedTickFunctionGroup->GetStats().AddCalls(TypedTickFunctionGroup->Num());
+				ClassExecutedCount += TypedTickFunctionGroup->Num();
 #endif
 
-				TickFunctionPtr.Execute(DeltaTime);
-				//TickFunctionPtr(DeltaTime);
+				TypedTickFunctionGroup->Tick(DeltaTime);
+			}
+
+			if (FrameContext.Budget)
+			{
+				FrameContext.Budget->Consume(FPlatformTime::Cycles64() - TypedStartCycles);
 			}
 		}
 
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+		RegisteredNativeObjectsArray[ClassIndex].GetStats().AddCalls(ClassExecutedCount);
+#endif
 	}
 
-	// for each blueprint object array that is sorted by class type...
-	for (const FTickAggregatedBlueprintObjectArray& BlueprintObjectArray : RegisteredBlueprintObjectsArray)
+	// blueprint functions are never deferred either, same as typed groups.
+	const uint64 BlueprintStartCycles = FPlatformTime::Cycles64();
+
+	// for each blueprint object array that is sorted by class type... (indexed loop, a script might register a new class)
+	for (int32 ClassIndex = 0; ClassIndex < RegisteredBlueprintObjectsArray.Num(); ++ClassIndex)
 	{
 		SCOPE_CYCLE_COUNTER(STAT_TickAggregator_TickBlueprintFunctions);
 
-		// take the pair of UObject & UFunction...
-		for (auto [WeakObjectPtr, Function] : BlueprintObjectArray.Get())
-		{
-			const UObject* Object = WeakObjectPtr.Get();
+		// all objects of the class share the same function, so parameter frame is set up once for the whole class.
+		// invoker is copied since the array it's stored in might be reallocated while the batch runs.
+		const FTickAggregatorBlueprintInvoker Invoker = RegisteredBlueprintObjectsArray[ClassIndex].GetInvoker();
+		Invoker.InvokeBatch(RegisteredBlueprintObjectsArray, ClassIndex, DeltaTime);
+	}
 
-#if TICK_AGGREGATOR_DO_CHECKS
-				if (!ensureMsgf(Object != nullptr, TEXT("Given object to tick aggregated was invalid!")))
-				{
-					continue;
-				}
+	// managers receive all objects of their class at once. (indexed loop, a manager might register a new batch)
+	for (int32 BatchIndex = 0; BatchIndex < RegisteredBlueprintBatches.Num(); ++BatchIndex)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_TickAggregator_TickBlueprintFunctions);
+		RegisteredBlueprintBatches[BatchIndex].Tick(DeltaTime);
+	}
 
-				if (!ensureMsgf(Function != nullptr, TEXT("Given function to tick aggregated was invalid!")))
-				{
-					continue;
-				}
+	if (FrameContext.Budget)
+	{
+		FrameContext.Budget->Consume(FPlatformTime::Cycles64() - BlueprintStartCycles);
+	}
+}
+
+FTickAggregatorBlueprintInvoker::FTickAggregatorBlueprintInvoker(UFunction* InFunction)
+	: Function(InFunction)
+{
+	if (!Function)
+	{
+		return;
+	}
+
+	// only plain script events with a single float parameter can skip ProcessEvent(). ubergraph functions use a persistent frame,
+	// RPCs have to be routed through the net driver and construction of locals would need the init/destructor links to be walked.
+	const FFloatProperty* DeltaSecondsProperty = CastField<FFloatProperty>(Function->ChildProperties);
+	bCanInvokeDirectly = DeltaSecondsProperty != nullptr
+		&& Function->NumParms == 1
+		&& Function->ReturnValueOffset == MAX_uint16
+		&& !Function->HasAnyFunctionFlags(FUNC_Native | FUNC_Net | FUNC_UbergraphFunction)
+		&& Function->FirstPropertyToInit == nullptr
+		&& Function->DestructorLink == nullptr
+		&& Function->Script.Num() > 0;
+
+	if (bCanInvokeDirectly)
+	{
+		PropertiesSize = Function->PropertiesSize;
+		MinAlignment = Function->GetMinAlignment();
+		DeltaSecondsOffset = DeltaSecondsProperty->GetOffset_ForUFunction();
+	}
+}
+
+void FTickAggregatorBlueprintInvoker::Invoke(UObject* Object, float DeltaTime) const
+{
+	if (!bCanInvokeDirectly)
+	{
+		// create a fake struct and pass it to BP VM, which will look for a float variable
+		// inside of it and pass it to called BP function. Jeez, BP VM is so strange.
+		Intax::TA::TickAggregatorDeltaSecondsParam Params(DeltaTime);
+		Object->ProcessEvent(Function, &Params);
+		return;
+	}
+
+	uint8* Frame = static_cast<uint8*>(FMemory_Alloca_Aligned(PropertiesSize, MinAlignment));
+	InvokeDirectly(Object, Frame, DeltaTime);
+}
+
+void FTickAggregatorBlueprintInvoker::InvokeBatch(const TArray<FTickAggregatedBlueprintObjectArray>& ObjectArrays, const int32 ClassIndex, float DeltaTime) const
+{
+#if TICK_AGGREGATOR_DO_CHECKS
+	if (!ensureMsgf(Function != nullptr, TEXT("Given function to tick aggregated was invalid!")))
+	{
+		return;
+	}
 #endif
 
-			// create a fake struct and pass it to BP VM, which will look for a float variable
-			// inside of it and pass it to called BP function. Jeez, BP VM is so strange.
+	uint8* Frame = bCanInvokeDirectly ? static_cast<uint8*>(FMemory_Alloca_Aligned(PropertiesSize, MinAlignment)) : nullptr;
+
+	// take the pair of UObject & UFunction... (indexed loop, arrays are fetched again after each call)
+	for (int32 Index = 0; Index < ObjectArrays[ClassIndex].Get().Num(); ++Index)
+	{
+		UObject* Object = ObjectArrays[ClassIndex].Get()[Index].Key;
+		if (!Intax::TA::IsTickableBlueprintObject(Object))
+		{
+			continue;
+		}
+
+		if (Frame)
+		{
+			InvokeDirectly(Object, Frame, DeltaTime);
+		}
+		else
+		{
 			Intax::TA::TickAggregatorDeltaSecondsParam Params(DeltaTime);
-			WeakObjectPtr->ProcessEvent(Function, &Params);
+			Object->ProcessEvent(Function, &Params);
 		}
 	}
 }
 
+void FTickAggregatorBlueprintInvoker::InvokeDirectly(UObject* Object, uint8* Frame, float DeltaTime) const
+{
+	// this is what ProcessEvent() ends up doing for a script function after all of it's checks.
+	FMemory::Memzero(Frame, PropertiesSize);
+	FMemory::Memcpy(Frame + DeltaSecondsOffset, &DeltaTime, sizeof(float));
+
+#if DO_BLUEPRINT_GUARD
+	// keeps runaway loop detection and script callstacks working, same as ProcessEvent().
+	FBlueprintContextTracker& BlueprintContextTracker = FBlueprintContextTracker::Get();
+	BlueprintContextTracker.EnterScriptContext(Object, Function);
+#endif
+
+	FFrame Stack(Object, Function, Frame, nullptr, Function->ChildProperties);
+	Function->Invoke(Object, Stack, nullptr);
+
+#if DO_BLUEPRINT_GUARD
+	BlueprintContextTracker.ExitScriptContext();
+#endif
+}
+
 void FAggregatedTickFunctionCollection::RemoveAndDestroyRequiredObjects()
 {
 	SCOPE_CYCLE_COUNTER(STAT_TickAggregator_RemoveObjects);
-	
-	for (int32 i = NativeFunctionsPendingRemove.Num() - 1; i >= 0; --i)
+
+	// functions were already marked when removal was requested, compact each dirty class array in one pass.
+	bool bAnyNativeObjectArrayEmptied = false;
+	for (const int32 ClassIndex : NativeObjectArraysPendingCompaction)
 	{
-		FTickAggregatorFunctionHandle& Handle = NativeFunctionsPendingRemove[i];
-		
-#if TICK_AGGREGATOR_DO_CHECKS
-		if (ensureMsgf(!Handle.IsValid(), TEXT("Given function handle in FunctionsPendingRemove was invalid!")))
+		FTickAggregatorNativeObjectArray& NativeObjectArray = RegisteredNativeObjectsArray[ClassIndex];
+		NativeObjectArray.CompactPendingRemove();
+
+		if (NativeObjectArray.IsEmpty())
 		{
-			continue;
+			NativeObjectArray.ReleaseUnusedMemory();
+			bAnyNativeObjectArrayEmptied = true;
 		}
-#endif
-
-		// @TODO this can be optimized even more. We shouldnt do lookup by predicate at each loop, but maybe we can build another data structure to do faster lookups.
+	}
+	NativeObjectArraysPendingCompaction.Reset();
 
-		const TSubclassOf<UObject> Class = Handle.GetClassType();
-		const auto Predicate = [Class](const FTickAggregatorNativeObjectArray& Array) { return Array.GetClassType() == Class; };
-		FTickAggregatorNativeObjectArray* FoundObjectArray = RegisteredNativeObjectsArray.FindByPredicate(Predicate);
+	// drop all empty class arrays from tick loop at once.
+	if (bAnyNativeObjectArrayEmptied)
+	{
+		ActiveNativeObjectArrays.RemoveAll([this](const int32 ClassIndex) { return RegisteredNativeObjectsArray[ClassIndex].IsEmpty(); });
+	}
 
-#if TICK_AGGREGATOR_DO_CHECKS
-		if (ensureMsgf(!FoundObjectArray, TEXT("Could not find object array associated with the given class for native object")))
+	if (BlueprintObjectsPendingRemove.Num() > 0)
+	{
+		for (FTickAggregatedBlueprintObjectArray& BlueprintObjectArray : RegisteredBlueprintObjectsArray)
 		{
-			continue;
+			BlueprintObjectArray.RemoveAll(BlueprintObjectsPendingRemove);
 		}
-#endif
 
-		FoundObjectArray->RemoveTickFunction(Handle.GetIdentity(), Handle.GetTickFunction());
-		if (FoundObjectArray->TickGroupArray.Num() == 0)
+		RemoveEmptyBlueprintObjectArrays();
+		BlueprintObjectsPendingRemove.Reset();
+	}
+
+	if (BlueprintBatchObjectsPendingRemove.Num() > 0)
+	{
+		for (FTickAggregatedBlueprintBatch& BlueprintBatch : RegisteredBlueprintBatches)
 		{
-			RegisteredNativeObjectsArray.Remove(*FoundObjectArray);
+			BlueprintBatch.Objects.RemoveAll(BlueprintBatchObjectsPendingRemove);
 		}
+		BlueprintBatchObjectsPendingRemove.Reset();
 	}
 
-	for (UObject* Object : BlueprintObjectsPendingRemove)
+	if (bBlueprintBatchesDirty)
 	{
-#if TICK_AGGREGATOR_DO_CHECKS
-		if (ensureMsgf(Object != nullptr, TEXT("Given UObject in BlueprintObjectsPendingRemove was invalid!")))
+		RegisteredBlueprintBatches.RemoveAll([](const FTickAggregatedBlueprintBatch& Batch) { return Batch.IsEmpty(); });
+		bBlueprintBatchesDirty = false;
+	}
+}
+
+void FAggregatedTickFunctionCollection::RemoveEmptyBlueprintObjectArrays()
+{
+	// no handles point to BP arrays, so empty ones can be erased. only the class lookup needs to be rebuilt.
+	const int32 NumRemovedArrays = RegisteredBlueprintObjectsArray.RemoveAll([](const FTickAggregatedBlueprintObjectArray& Array) { return Array.IsEmpty(); });
+	if (NumRemovedArrays > 0)
+	{
+		BlueprintClassIndices.Reset();
+		for (int32 ClassIndex = 0; ClassIndex < RegisteredBlueprintObjectsArray.Num(); ++ClassIndex)
 		{
-			continue;
+			BlueprintClassIndices.Add(RegisteredBlueprintObjectsArray[ClassIndex].GetClassType()->GetUniqueID(), ClassIndex);
 		}
-#endif
+	}
+}
 
-		UClass* Class = Object->GetClass();
-		const auto Predicate = [Class](const FTickAggregatedBlueprintObjectArray& Array) { return Array.GetClassType() == Class; };
-		FTickAggregatedBlueprintObjectArray* FoundObjectArray = RegisteredBlueprintObjectsArray.FindByPredicate(Predicate);
-#if TICK_AGGREGATOR_DO_CHECKS
-		if (ensureMsgf(FoundObjectArray != nullptr, TEXT("Could not find object array associated with the given class for BP object")))
+void FAggregatedTickFunctionCollection::RemoveUnreachableObjects()
+{
+	int32 NumRemovedObjects = 0;
+	for (FTickAggregatedBlueprintObjectArray& BlueprintObjectArray : RegisteredBlueprintObjectsArray)
+	{
+		NumRemovedObjects += BlueprintObjectArray.RemoveUnreachable();
+	}
+
+	if (NumRemovedObjects > 0)
+	{
+		RemoveEmptyBlueprintObjectArrays();
+	}
+
+	for (FTickAggregatedBlueprintBatch& BlueprintBatch : RegisteredBlueprintBatches)
+	{
+		if (BlueprintBatch.Objects.RemoveUnreachable() > 0 || !BlueprintBatch.Manager.IsValid())
 		{
-			continue;
+			bBlueprintBatchesDirty = true;
 		}
-#endif
+	}
+
+	// these are already swept above, and their addresses can be reused by new objects before our next tick.
+	Intax::TA::Private::RemoveUnreachableObjects(BlueprintObjectsPendingRemove);
+	Intax::TA::Private::RemoveUnreachableObjects(BlueprintBatchObjectsPendingRemove);
+}
+
+void FTickAggregatedBlueprintBatch::Tick(float DeltaTime) const
+{
+	UObject* ManagerObject = Manager.Get();
+	if (!ManagerObject || !ManagerFunction)
+	{
+		return;
+	}
 
-		UFunction* Function = Object->FindFunctionChecked(Intax::TA::BlueprintTickFunctionName);
-		FoundObjectArray->RemoveSwap(Object, Function);
-		if (FoundObjectArray->Get().Num() == 0)
+	// params are local, manager might register a new batch and move this one while it's event is running.
+	Intax::TA::TickAggregatorBatchParams Params;
+	Params.Objects.Reserve(Objects.Get().Num());
+	for (const FTickAggregatorBlueprintElement& Pair : Objects.Get())
+	{
+		if (Intax::TA::IsTickableBlueprintObject(Pair.Key))
 		{
-			RegisteredBlueprintObjectsArray.Remove(*FoundObjectArray);
+			Params.Objects.Add(Pair.Key);
 		}
 	}
+
+	if (Params.Objects.Num() > 0)
+	{
+		Params.DeltaTime = DeltaTime;
+		ManagerObject->ProcessEvent(ManagerFunction, &Params);
+	}
 }
 
-FTickAggregatorFunctionHandle FAggregatedTickFunctionCollection::AddNewNativeFunction(const UObject* Object, const FAggregatedTickDelegate& Function, const FName TickFunctionGroupName)
+FTickAggregatorFunctionHandle FAggregatedTickFunctionCollection::AddNewNativeFunction(const UObject* Object, const FAggregatedTickDelegate& Function, const FTickFunctionGroupId TickFunctionGroupName, const FTickFunctionGroupSettings& Settings)
 {
 	using namespace Intax::TA;
 
@@ -157,34 +388,89 @@ FTickAggregatorFunctionHandle FAggregatedTickFunctionCollection::AddNewNativeFun
 		return MakeInvalidFunctionHandle();
 	}
 
-	// try to find existing object array with given object's class type.
-	auto Predicate = [Class](const FTickAggregatorNativeObjectArray& ObjectArray) { return ObjectArray.IsA(Class); };
-	FTickAggregatorNativeObjectArray* FoundObjectArray = RegisteredNativeObjectsArray.FindByPredicate(Predicate);
-	if (FoundObjectArray)
+	int32 ClassIndex = INDEX_NONE;
+	int32 GroupIndex = INDEX_NONE;
+	FTickAggregatorNativeObjectArray& ObjectArray = FindOrAddNativeObjectArray(Class, ClassIndex);
+	const FTickAggregatorSlotId Slot = ObjectArray.AddNewTickFunction(TickFunctionGroupName, Function, Settings, GroupIndex);
+	if (Slot.IsValid())
 	{
-		const int32 Index = FoundObjectArray->AddNewTickFunction(TickFunctionGroupName, Function);
-		if (Index != INDEX_NONE)
-		{
-			return MakeFunctionHandle(Index, AssociatedTickCategory, AssociatedTickingGroup, Class, TickFunctionGroupName);
-		}
+		return MakeNativeFunctionHandle(ObjectArray, ClassIndex, GroupIndex, false, Slot);
+	}
 
-		return MakeInvalidFunctionHandle();
+	return MakeInvalidFunctionHandle();
+}
+
+FTickAggregatorFunctionHandle FAggregatedTickFunctionCollection::MakeNativeFunctionHandle(FTickAggregatorNativeObjectArray& ObjectArray, const int32 ClassIndex, const int32 GroupIndex, const bool bTypedFunction, const FTickAggregatorSlotId Slot)
+{
+	OnNativeFunctionAdded(ObjectArray, ClassIndex);
+
+	const FTickAggregatorFunctionHandle Handle = Intax::TA::MakeFunctionHandle(Slot, ClassIndex, GroupIndex, bTypedFunction, AssociatedTickCategory, AssociatedTickingGroup);
+	if (!Handle.IsValid())
+	{
+		// caller can't remove a function it has no handle of, it would tick forever.
+		MarkNativeFunctionPendingRemove(ClassIndex, GroupIndex, bTypedFunction, Slot);
 	}
-	else // if there isnt one existing for given object type, create a new one and add object's function to it.
+
+	return Handle;
+}
+
+FTickAggregatorNativeObjectArray& FAggregatedTickFunctionCollection::FindOrAddNativeObjectArray(UClass* Class, int32& OutClassIndex)
+{
+	// try to find existing object array with given object's class type. class might be a new one that reused the
+	// internal index of a destroyed class (i.e. recompiled BP), so make sure it's really the same class.
+	if (const int32* FoundClassIndex = NativeClassIndices.Find(Class->GetUniqueID()))
 	{
-		const int32 Index = BuildNewObjectArrayFor<FTickAggregatorNativeObjectArray>(Class).AddNewTickFunction(TickFunctionGroupName, Function);
-		if (Index != INDEX_NONE)
+		if (RegisteredNativeObjectsArray[*FoundClassIndex].IsA(Class))
 		{
-			return MakeFunctionHandle(Index, AssociatedTickCategory, AssociatedTickingGroup, Class, TickFunctionGroupName);
+			OutClassIndex = *FoundClassIndex;
+			return RegisteredNativeObjectsArray[OutClassIndex];
 		}
-
-		return MakeInvalidFunctionHandle();
 	}
+
+	// if there isnt one existing for given object type, create a new one.
+	FTickAggregatorNativeObjectArray& NewObjectArray = BuildNewObjectArrayFor<FTickAggregatorNativeObjectArray>(Class);
+	OutClassIndex = RegisteredNativeObjectsArray.Num() - 1;
+	NativeClassIndices.Add(Class->GetUniqueID(), OutClassIndex);
+	return NewObjectArray;
 }
 
 bool FAggregatedTickFunctionCollection::AddNewRemoveRequest(const FTickAggregatorFunctionHandle& InHandle)
 {
-	return NativeFunctionsPendingRemove.AddUnique(InHandle) > INDEX_NONE;
+	if (!ensureMsgf(InHandle.IsValid(), TEXT("Given function handle to remove was invalid!")))
+	{
+		return false;
+	}
+
+	// handle knows exactly where the function lives, no lookups needed.
+	if (!ensureMsgf(RegisteredNativeObjectsArray.IsValidIndex(InHandle.GetClassIndex()), TEXT("Could not find object array associated with the given handle for native object")))
+	{
+		return false;
+	}
+
+	// just mark the function, storage is compacted before next tick. stale handles (i.e. removed twice) are rejected here.
+	return MarkNativeFunctionPendingRemove(InHandle.GetClassIndex(), InHandle.GetGroupIndex(), InHandle.IsTypedFunction(), InHandle.GetSlot());
+}
+
+bool FAggregatedTickFunctionCollection::MarkNativeFunctionPendingRemove(const int32 ClassIndex, const int32 GroupIndex, const bool bTypedFunction, const FTickAggregatorSlotId Slot)
+{
+	FTickAggregatorNativeObjectArray& NativeObjectArray = RegisteredNativeObjectsArray[ClassIndex];
+	const bool bWasPendingCompaction = NativeObjectArray.HasPendingRemove();
+	if (!NativeObjectArray.MarkPendingRemove(GroupIndex, bTypedFunction, Slot))
+	{
+		return false;
+	}
+
+	if (!bWasPendingCompaction)
+	{
+		NativeObjectArraysPendingCompaction.Add(ClassIndex);
+	}
+
+	return true;
+}
+
+bool FAggregatedTickFunctionCollection::ContainsNativeFunction(const FTickAggregatorFunctionHandle& InHandle) const
+{
+	return InHandle.IsValid() && RegisteredNativeObjectsArray.IsValidIndex(InHandle.GetClassIndex()) && RegisteredNativeObjectsArray[InHandle.GetClassIndex()].Contains(InHandle);
 }
 
 bool FAggregatedTickFunctionCollection::AddNewBlueprintFunction(UObject* Object)
@@ -206,194 +492,1112 @@ bool FAggregatedTickFunctionCollection::AddNewBlueprintFunction(UObject* Object)
 		return false;
 	}
 
-	auto Predicate = [Class](const FTickAggregatedBlueprintObjectArray& ObjectArray) { return ObjectArray.IsA(Class); };
-	FTickAggregatedBlueprintObjectArray* FoundObjectArray = RegisteredBlueprintObjectsArray.FindByPredicate(Predicate);
-	if (FoundObjectArray)
-	{
-		return FoundObjectArray->AddUnique(Object, Function) > INDEX_NONE;
-	}
-	else
+	const int32* FoundClassIndex = BlueprintClassIndices.Find(Class->GetUniqueID());
+	if (FoundClassIndex && RegisteredBlueprintObjectsArray[*FoundClassIndex].IsA(Class))
+	{
+		return RegisteredBlueprintObjectsArray[*FoundClassIndex].AddUnique(Object, Function) > INDEX_NONE;
+	}
+	else
+	{
+		BlueprintClassIndices.Add(Class->GetUniqueID(), RegisteredBlueprintObjectsArray.Num());
+		return BuildNewObjectArrayFor<FTickAggregatedBlueprintObjectArray>(Class).Add(Object, Function) > INDEX_NONE;
+	}
+}
+
+bool FAggregatedTickFunctionCollection::AddNewBlueprintRemoveRequest(UObject* Object)
+{
+	bool bAlreadyPending = false;
+	BlueprintObjectsPendingRemove.Add(Object, &bAlreadyPending);
+	return !bAlreadyPending;
+}
+
+FTickAggregatedBlueprintBatch& FAggregatedTickFunctionCollection::FindOrAddBlueprintBatch(UClass* Class)
+{
+	for (FTickAggregatedBlueprintBatch& BlueprintBatch : RegisteredBlueprintBatches)
+	{
+		if (BlueprintBatch.Objects.IsA(Class))
+		{
+			return BlueprintBatch;
+		}
+	}
+
+	return RegisteredBlueprintBatches.Emplace_GetRef(Class);
+}
+
+bool FAggregatedTickFunctionCollection::AddNewBlueprintBatchManager(UObject* Manager, UClass* ObjectClass)
+{
+	UFunction* Function = Manager->GetClass()->FindFunctionByName(Intax::TA::BlueprintBatchTickFunctionName);
+	if (!ensure(Function))
+	{
+		return false;
+	}
+
+	FTickAggregatedBlueprintBatch& BlueprintBatch = FindOrAddBlueprintBatch(ObjectClass);
+	if (!ensureMsgf(!BlueprintBatch.Manager.IsValid() || BlueprintBatch.Manager == Manager, TEXT("Class %s already has a batch manager %s, %s is ignored."),
+		*GetNameSafe(ObjectClass), *GetNameSafe(BlueprintBatch.Manager.Get()), *GetNameSafe(Manager)))
+	{
+		return false;
+	}
+
+	BlueprintBatch.Manager = Manager;
+	BlueprintBatch.ManagerFunction = Function;
+	return true;
+}
+
+bool FAggregatedTickFunctionCollection::RemoveBlueprintBatchManager(UObject* Manager, UClass* ObjectClass)
+{
+	for (FTickAggregatedBlueprintBatch& BlueprintBatch : RegisteredBlueprintBatches)
+	{
+		if (BlueprintBatch.Objects.IsA(ObjectClass) && BlueprintBatch.Manager == Manager)
+		{
+			// storage isn't touched, so it's safe to remove the manager during it's own event.
+			BlueprintBatch.Manager.Reset();
+			BlueprintBatch.ManagerFunction = nullptr;
+			bBlueprintBatchesDirty = true;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FAggregatedTickFunctionCollection::AddNewBlueprintBatchObject(UObject* Object)
+{
+	UClass* Class = Object->GetClass();
+	if (!ensure(Class))
+	{
+		return false;
+	}
+
+	return FindOrAddBlueprintBatch(Class).Objects.AddUnique(Object, nullptr) != INDEX_NONE;
+}
+
+bool FAggregatedTickFunctionCollection::AddNewBlueprintBatchRemoveRequest(UObject* Object)
+{
+	bool bAlreadyPending = false;
+	BlueprintBatchObjectsPendingRemove.Add(Object, &bAlreadyPending);
+	bBlueprintBatchesDirty = true;
+	return !bAlreadyPending;
+}
+
+#if WITH_EDITOR
+void FAggregatedTickFunctionCollection::DumpTicks(const FString& CategoryName)
+{
+	if (RegisteredNativeObjectsArray.IsEmpty())
+	{
+		TA_LOG(Log, "---");
+		TA_LOG(Log, "%s is empty.", *CategoryName);
+		TA_LOG(Log, "---");
+	}
+	else
+	{
+		TA_LOG(Log, "---");
+		TA_LOG(Log, "%s Tick Functions:", *CategoryName);
+		for (const FTickAggregatorNativeObjectArray& NativeObjects : RegisteredNativeObjectsArray)
+		{
+			const TIndirectArray<FTickFunctionGroup>& Array = NativeObjects.Get();
+			for (const FTickFunctionGroup& TickFunctionGroup : Array)
+			{
+				const TArray<FTickFunctionGroup::FElement>& TickFunctionArray = TickFunctionGroup.Get();
+				for (const FTickFunctionGroup::FElement& Element : TickFunctionArray)
+				{
+					TA_LOG(Log, "OBJECT: %s - DEFINITION: %s", *GetNameSafe(Element.Function.GetUObject()), *TickFunctionGroup.GetDefinition().ToString());
+				}
+			}
+
+			for (const TUniquePtr<FTypedTickFunctionGroupBase>& TypedTickFunctionGroup : NativeObjects.GetTypedGroups())
+			{
+				TA_LOG(Log, "CLASS: %s - TYPED DEFINITION: %s - COUNT: %d", *GetNameSafe(NativeObjects.GetClassType()), *TypedTickFunctionGroup->GetDefinition().ToString(), TypedTickFunctionGroup->Num());
+			}
+		}
+		TA_LOG(Log, "---");
+	}
+}
+#endif
+
+FTickFunctionGroup::FTickFunctionGroup(const FTickFunctionGroupId InIdentity, const FTickFunctionGroupSettings& InSettings)
+	: Id(InIdentity), Definition(InIdentity.ToName()), Priority(InSettings.Priority), bThreadSafe(InSettings.bThreadSafe), Mode(InSettings.Mode)
+{
+	if (Mode == ETickFunctionGroupMode::TimeSliced)
+	{
+		ensureMsgf(InSettings.TimeSliceBudgetMicroseconds > 0.f, TEXT("Time-sliced group %s has no time budget, only a single function will be ticked per frame."), *Definition.ToString());
+		TimeSliceBudgetCycles = static_cast<uint64>(FMath::Max(InSettings.TimeSliceBudgetMicroseconds, 0.f) * 1e-6 / FPlatformTime::GetSecondsPerCycle64());
+	}
+	else if (Mode == ETickFunctionGroupMode::RoundRobin)
+	{
+		ensureMsgf(InSettings.RoundRobinFrameCount > 0, TEXT("Round-robin group %s has invalid frame count %d, functions will tick every frame."), *Definition.ToString(), InSettings.RoundRobinFrameCount);
+		RoundRobinFrameCount = FMath::Max(InSettings.RoundRobinFrameCount, 1);
+	}
+	else if (Mode == ETickFunctionGroupMode::Interval)
+	{
+		ensureMsgf(InSettings.IntervalSeconds > 0.f, TEXT("Interval group %s has invalid interval %f, functions will tick every frame."), *Definition.ToString(), InSettings.IntervalSeconds);
+		IntervalSeconds = FMath::Max(InSettings.IntervalSeconds, 0.f);
+	}
+
+	if (InSettings.bUseDistanceLOD)
+	{
+		if (ensureMsgf(Mode == ETickFunctionGroupMode::EveryFrame, TEXT("Distance LOD is only supported by EveryFrame groups, group %s will tick without LOD."), *Definition.ToString()))
+		{
+			bUseDistanceLOD = true;
+			LODEvaluationsPerFrame = FMath::Max(InSettings.LODEvaluationsPerFrame, 1);
+			LODDistancesSquared[static_cast<int32>(ETickAggregatorLOD::Full)] = FMath::Square(static_cast<double>(InSettings.FullRateDistance));
+			LODDistancesSquared[static_cast<int32>(ETickAggregatorLOD::Half)] = FMath::Square(static_cast<double>(InSettings.HalfRateDistance));
+			LODDistancesSquared[static_cast<int32>(ETickAggregatorLOD::Quarter)] = FMath::Square(static_cast<double>(InSettings.QuarterRateDistance));
+		}
+	}
+}
+
+FTickAggregatorSlotId FTickFunctionGroup::Add(const FAggregatedTickDelegate& Elem)
+{
+	// new functions start counting their delta from now, not from creation of the group.
+	const FTickAggregatorSlotId Slot = TickFunctionDelegates.Emplace(Elem, GroupTime);
+
+	if (bUseDistanceLOD)
+	{
+		// appended functions are at the end of dormant bucket, new functions tick at full rate until their LOD is evaluated.
+		const int32 DenseIndex = TickFunctionDelegates.Num() - 1;
+		TickFunctionDelegates.GetElements()[DenseIndex].LOD = ETickAggregatorLOD::Dormant;
+		MoveToLOD(DenseIndex, ETickAggregatorLOD::Full);
+	}
+
+	return Slot;
+}
+
+int32 FTickFunctionGroup::CompactPendingRemove()
+{
+	// keep the cursor on the same function, so compaction doesn't make time-sliced groups skip or repeat functions.
+	const int32 NumRemoved = TickFunctionDelegates.CompactPendingRemove(&Cursor);
+
+	// compaction keeps the order, so buckets are still partitioned. only their ends moved.
+	if (bUseDistanceLOD && NumRemoved > 0)
+	{
+		int32 BucketCounts[static_cast<int32>(ETickAggregatorLOD::MAX)] = {};
+		for (const FElement& Element : TickFunctionDelegates.GetElements())
+		{
+			++BucketCounts[static_cast<int32>(Element.LOD)];
+		}
+
+		int32 BucketEnd = 0;
+		for (int32 BucketIndex = 0; BucketIndex < static_cast<int32>(ETickAggregatorLOD::Dormant); ++BucketIndex)
+		{
+			BucketEnd += BucketCounts[BucketIndex];
+			LODBucketEnds[BucketIndex] = BucketEnd;
+		}
+	}
+
+	return NumRemoved;
+}
+
+void FTickFunctionGroup::MergeSettings(const FTickFunctionGroupSettings& InSettings)
+{
+	bThreadSafe &= InSettings.bThreadSafe;
+
+	ensureMsgf(InSettings.Mode == Mode, TEXT("Function is registered to tick function group %s with a different mode, it will use the mode of the group."), *Definition.ToString());
+	ensureMsgf(InSettings.bUseDistanceLOD == bUseDistanceLOD, TEXT("Function is registered to tick function group %s with different LOD settings, it will use the LOD settings of the group."), *Definition.ToString());
+
+	// a more important function makes whole group more important, same as thread-safety.
+	Priority = FMath::Min(Priority, InSettings.Priority);
+}
+
+int32 FTickFunctionGroup::Tick(float DeltaTime, const FTickAggregatorFrameContext& FrameContext)
+{
+	GroupTime += DeltaTime;
+	DeferredDeltaTime += DeltaTime;
+
+	FTickAggregatorFrameBudget* Budget = FrameContext.Budget;
+	if (Budget && !Budget->CanTick(Priority) && DeferredFrameCount < Intax::TA::MaxDeferredFrames)
+	{
+		// functions measure their delta against GroupTime, so deferred frames are carried to their next tick automatically.
+		++DeferredFrameCount;
+		return 0;
+	}
+
+	const float TickDeltaTime = DeferredDeltaTime;
+	DeferredDeltaTime = 0.f;
+	DeferredFrameCount = 0;
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	int32 ExecutedCount = 0;
+	{
+		TA_TRACE_SCOPE(TraceName);
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+		FScopeCycleCounter GroupCycleCounter(Stats.CycleStatId);
+#endif
+		ExecutedCount = TickByMode(TickDeltaTime, FrameContext);
+	}
+
+	TRACE_COUNTER_ADD(TickAggregator_ExecutedFunctions, ExecutedCount);
+
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+	Stats.AddCalls(ExecutedCount);
+#endif
+
+	if (Budget)
+	{
+		Budget->Consume(FPlatformTime::Cycles64() - StartCycles);
+	}
+
+	return ExecutedCount;
+}
+
+int32 FTickFunctionGroup::TickByMode(float DeltaTime, const FTickAggregatorFrameContext& FrameContext)
+{
+	if (bUseDistanceLOD)
+	{
+		EvaluateLOD(FrameContext);
+		return TickLODBuckets();
+	}
+
+	if (Mode == ETickFunctionGroupMode::TimeSliced)
+	{
+		return TickTimeSliced();
+	}
+
+	if (Mode == ETickFunctionGroupMode::RoundRobin)
+	{
+		return TickRoundRobin();
+	}
+
+	if (Mode == ETickFunctionGroupMode::Interval)
+	{
+		return TickInterval(DeltaTime);
+	}
+
+	const int32 FunctionCount = TickFunctionDelegates.Num();
+
+	if (bThreadSafe && FunctionCount > Intax::TA::ParallelTickBatchSize)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_TickAggregator_TickParallelNativeFunctions);
+
+		const int32 BatchCount = FMath::DivideAndRoundUp(FunctionCount, Intax::TA::ParallelTickBatchSize);
+
+		// ParallelFor doesn't return until every batch is executed, so next group never overlaps with this one.
+		ParallelFor(BatchCount, [this, FunctionCount, DeltaTime](const int32 BatchIndex)
+		{
+			const int32 IndexBegin = BatchIndex * Intax::TA::ParallelTickBatchSize;
+			const int32 IndexEnd = FMath::Min(IndexBegin + Intax::TA::ParallelTickBatchSize, FunctionCount);
+			TickRange(IndexBegin, IndexEnd, DeltaTime);
+		});
+	}
+	else
+	{
+		TickRange(0, FunctionCount, DeltaTime);
+	}
+
+	return FunctionCount;
+}
+
+void FTickFunctionGroup::TickRange(const int32 InIndexBegin, const int32 InIndexEnd, float DeltaTime) const
+{
+	// get tick function delegates and invoke them.
+	for (int32 Index = InIndexBegin; Index < InIndexEnd; ++Index)
+	{
+		const FAggregatedTickDelegate& TickFunctionPtr = TickFunctionDelegates.GetElements()[Index].Function;
+
+#if TICK_AGGREGATOR_DO_CHECKS
+		if (!ensureAlwaysMsgf(TickFunctionPtr.IsBound(), TEXT("TickFunctionPtr was not bound to anything?!")))
+		{
+			continue;
+		}
+#endif
+
+		TickFunctionPtr.Execute(DeltaTime);
+	}
+}
+
+int32 FTickFunctionGroup::TickTimeSliced()
+{
+	const int32 FunctionCount = TickFunctionDelegates.Num();
+	if (FunctionCount == 0)
+	{
+		return 0;
+	}
+
+	if (Cursor >= FunctionCount)
+	{
+		Cursor = 0;
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	// tick each function at most once per frame, so a cheap group doesn't tick it's functions several times with zero delta.
+	// first function is always ticked, otherwise a budget smaller than a single function would starve the whole group.
+	int32 TickedCount = 0;
+	for (; TickedCount < FunctionCount; ++TickedCount)
+	{
+		if (TickedCount > 0 && FPlatformTime::Cycles64() - StartCycles >= TimeSliceBudgetCycles)
+		{
+			break;
+		}
+
+		TickElement(TickFunctionDelegates.GetElements()[Cursor]);
+
+		if (++Cursor == FunctionCount)
+		{
+			Cursor = 0;
+		}
+	}
+
+	return TickedCount;
+}
+
+int32 FTickFunctionGroup::TickRoundRobin()
+{
+	// slice is calculated every frame, so functions added or removed in the middle of a round don't unbalance the next frames.
+	return TickFromCursor(FMath::DivideAndRoundUp(TickFunctionDelegates.Num(), RoundRobinFrameCount));
+}
+
+int32 FTickFunctionGroup::TickInterval(float DeltaTime)
+{
+	const int32 FunctionCount = TickFunctionDelegates.Num();
+	if (IntervalSeconds <= 0.f)
+	{
+		return TickFromCursor(FunctionCount);
+	}
+
+	// instead of ticking whole group when interval is reached, tick the share of the group that became due this frame.
+	// the cursor walks the group once per interval, so functions end up in different phases and the cost is flat across frames.
+	// debt is clamped, so a hitch ticks each function at most once instead of catching up over the next frames.
+	IntervalTickDebt = FMath::Min(IntervalTickDebt + FunctionCount * DeltaTime / IntervalSeconds, static_cast<double>(FunctionCount));
+
+	// debt is never negative, so truncation floors it.
+	const int32 TickCount = static_cast<int32>(IntervalTickDebt);
+	IntervalTickDebt -= TickCount;
+
+	return TickFromCursor(TickCount);
+}
+
+int32 FTickFunctionGroup::TickFromCursor(const int32 Count)
+{
+	const int32 FunctionCount = TickFunctionDelegates.Num();
+	if (FunctionCount == 0)
+	{
+		return 0;
+	}
+
+	if (Cursor >= FunctionCount)
+	{
+		Cursor = 0;
+	}
+
+	const int32 TickCount = FMath::Min(Count, FunctionCount);
+	for (int32 TickedCount = 0; TickedCount < TickCount; ++TickedCount)
+	{
+		TickElement(TickFunctionDelegates.GetElements()[Cursor]);
+
+		if (++Cursor == FunctionCount)
+		{
+			Cursor = 0;
+		}
+	}
+
+	return TickCount;
+}
+
+void FTickFunctionGroup::EvaluateLOD(const FTickAggregatorFrameContext& FrameContext)
+{
+	const int32 FunctionCount = TickFunctionDelegates.Num();
+	if (FunctionCount == 0 || !FrameContext.ViewLocations)
+	{
+		return;
+	}
+
+	const TArray<FVector, TInlineAllocator<4>>& ViewLocations = FrameContext.ViewLocations->Get();
+	if (ViewLocations.IsEmpty())
+	{
+		return;
+	}
+
+	// functions that move to another bucket swap places with others, so a function might be skipped or evaluated twice in a
+	// round. that's fine, next round catches it up and we never pay more than LODEvaluationsPerFrame per frame.
+	const int32 EvaluationCount = FMath::Min(LODEvaluationsPerFrame, FunctionCount);
+	for (int32 EvaluatedCount = 0; EvaluatedCount < EvaluationCount; ++EvaluatedCount)
+	{
+		if (Cursor >= FunctionCount)
+		{
+			Cursor = 0;
+		}
+
+		const FElement& Element = TickFunctionDelegates.GetElements()[Cursor];
+
+		FVector ObjectLocation;
+		if (Intax::TA::Private::GetTickObjectLocation(Element.Function.GetUObject(), ObjectLocation))
+		{
+			double MinDistanceSquared = TNumericLimits<double>::Max();
+			for (const FVector& ViewLocation : ViewLocations)
+			{
+				MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(ObjectLocation, ViewLocation));
+			}
+
+			ETickAggregatorLOD NewLOD = ETickAggregatorLOD::Dormant;
+			for (int32 BucketIndex = 0; BucketIndex < static_cast<int32>(ETickAggregatorLOD::Dormant); ++BucketIndex)
+			{
+				if (MinDistanceSquared <= LODDistancesSquared[BucketIndex])
+				{
+					NewLOD = static_cast<ETickAggregatorLOD>(BucketIndex);
+					break;
+				}
+			}
+
+			if (NewLOD != Element.LOD)
+			{
+				MoveToLOD(Cursor, NewLOD);
+			}
+		}
+
+		++Cursor;
+	}
+}
+
+int32 FTickFunctionGroup::TickLODBuckets()
+{
+	++LODFrameCounter;
+
+	int32 TickedCount = 0;
+	TickedCount += TickLODBucket(0, LODBucketEnds[static_cast<int32>(ETickAggregatorLOD::Full)], 1);
+	TickedCount += TickLODBucket(LODBucketEnds[static_cast<int32>(ETickAggregatorLOD::Full)], LODBucketEnds[static_cast<int32>(ETickAggregatorLOD::Half)], 2);
+	TickedCount += TickLODBucket(LODBucketEnds[static_cast<int32>(ETickAggregatorLOD::Half)], LODBucketEnds[static_cast<int32>(ETickAggregatorLOD::Quarter)], 4);
+	return TickedCount;
+}
+
+int32 FTickFunctionGroup::TickLODBucket(const int32 InIndexBegin, const int32 InIndexEnd, const int32 Stride)
+{
+	const int32 FirstIndex = InIndexBegin + static_cast<int32>(LODFrameCounter % Stride);
+	if (FirstIndex >= InIndexEnd)
+	{
+		return 0;
+	}
+
+	const int32 TickCount = FMath::DivideAndRoundUp(InIndexEnd - FirstIndex, Stride);
+	auto TickBatch = [this, FirstIndex, Stride](const int32 BatchBegin, const int32 BatchEnd)
+	{
+		for (int32 TickIndex = BatchBegin; TickIndex < BatchEnd; ++TickIndex)
+		{
+			TickElement(TickFunctionDelegates.GetElements()[FirstIndex + TickIndex * Stride]);
+		}
+	};
+
+	if (bThreadSafe && TickCount > Intax::TA::ParallelTickBatchSize)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_TickAggregator_TickParallelNativeFunctions);
+
+		// each batch writes only to it's own elements, so they don't need any synchronization.
+		const int32 BatchCount = FMath::DivideAndRoundUp(TickCount, Intax::TA::ParallelTickBatchSize);
+		ParallelFor(BatchCount, [&TickBatch, TickCount](const int32 BatchIndex)
+		{
+			const int32 BatchBegin = BatchIndex * Intax::TA::ParallelTickBatchSize;
+			TickBatch(BatchBegin, FMath::Min(BatchBegin + Intax::TA::ParallelTickBatchSize, TickCount));
+		});
+	}
+	else
+	{
+		TickBatch(0, TickCount);
+	}
+
+	return TickCount;
+}
+
+int32 FTickFunctionGroup::MoveToLOD(const int32 DenseIndex, const ETickAggregatorLOD NewLOD)
+{
+	int32 Index = DenseIndex;
+	int32 Bucket = static_cast<int32>(TickFunctionDelegates.GetElements()[Index].LOD);
+	const int32 TargetBucket = static_cast<int32>(NewLOD);
+
+	// moving to a lower rate: swap with the last function of current bucket, then shrink the bucket so function is in the next one.
+	while (Bucket < TargetBucket)
+	{
+		const int32 LastIndex = LODBucketEnds[Bucket] - 1;
+		TickFunctionDelegates.Swap(Index, LastIndex);
+		Index = LastIndex;
+		--LODBucketEnds[Bucket];
+		++Bucket;
+	}
+
+	// moving to a higher rate: swap with the first function of current bucket, then grow the previous bucket over it.
+	while (Bucket > TargetBucket)
+	{
+		const int32 FirstIndex = LODBucketEnds[Bucket - 1];
+		TickFunctionDelegates.Swap(Index, FirstIndex);
+		Index = FirstIndex;
+		++LODBucketEnds[Bucket - 1];
+		--Bucket;
+	}
+
+	TickFunctionDelegates.GetElements()[Index].LOD = NewLOD;
+	return Index;
+}
+
+FTickAggregatorSlotId FTickAggregatorNativeObjectArray::AddNewTickFunction(const FTickFunctionGroupId Identity, const FAggregatedTickDelegate& FunctionPtr, const FTickFunctionGroupSettings& Settings, int32& OutGroupIndex)
+{
+	if ((!Identity.IsValid() || !FunctionPtr.IsBound()))
+	{
+		return FTickAggregatorSlotId();
+	}
+
+	if (const int32* FoundGroupIndex = TickGroupIndices.Find(Identity.GetValue()))
+	{
+		OutGroupIndex = *FoundGroupIndex;
+		TickGroupArray[OutGroupIndex].MergeSettings(Settings);
+#if TICK_AGGREGATOR_DO_CHECKS
+		Identity.CheckCollision();
+#endif
+	}
+	else
+	{
+		OutGroupIndex = TickGroupArray.Add(new FTickFunctionGroup(Identity, Settings));
+		TickGroupIndices.Add(Identity.GetValue(), OutGroupIndex);
+
+		TickGroupArray[OutGroupIndex].InitializeProfiling(ClassType);
+	}
+
+	++NumFunctions;
+	TRACE_COUNTER_INCREMENT(TickAggregator_AddedFunctions);
+	return TickGroupArray[OutGroupIndex].Add(FunctionPtr);
+}
+
+bool FTickAggregatorNativeObjectArray::MarkPendingRemove(const FTickAggregatorFunctionHandle& Handle)
+{
+	return MarkPendingRemove(Handle.GetGroupIndex(), Handle.IsTypedFunction(), Handle.GetSlot());
+}
+
+bool FTickAggregatorNativeObjectArray::MarkPendingRemove(const int32 GroupIndex, const bool bTypedFunction, const FTickAggregatorSlotId Slot)
+{
+	bool bMarked = false;
+	if (bTypedFunction)
+	{
+		bMarked = TypedTickGroupArray.IsValidIndex(GroupIndex) && TypedTickGroupArray[GroupIndex]->MarkPendingRemove(Slot);
+	}
+	else
+	{
+		bMarked = TickGroupArray.IsValidIndex(GroupIndex) && TickGroupArray[GroupIndex].MarkPendingRemove(Slot);
+	}
+
+	if (bMarked)
+	{
+		++NumPendingRemove;
+	}
+
+	return bMarked;
+}
+
+bool FTickAggregatorNativeObjectArray::Contains(const FTickAggregatorFunctionHandle& Handle) const
+{
+	const FTickAggregatorSlotId Slot = Handle.GetSlot();
+	const int32 GroupIndex = Handle.GetGroupIndex();
+
+	if (Handle.IsTypedFunction())
+	{
+		return TypedTickGroupArray.IsValidIndex(GroupIndex) && TypedTickGroupArray[GroupIndex]->Contains(Slot);
+	}
+
+	return TickGroupArray.IsValidIndex(GroupIndex) && TickGroupArray[GroupIndex].Contains(Slot);
+}
+
+void FTickAggregatorNativeObjectArray::CompactPendingRemove()
+{
+	if (NumPendingRemove == 0)
+	{
+		return;
+	}
+
+	int32 NumRemoved = 0;
+	for (FTickFunctionGroup& TickFunctionGroup : TickGroupArray)
+	{
+		NumRemoved += TickFunctionGroup.CompactPendingRemove();
+	}
+
+	for (const TUniquePtr<FTypedTickFunctionGroupBase>& TypedTickFunctionGroup : TypedTickGroupArray)
+	{
+		NumRemoved += TypedTickFunctionGroup->CompactPendingRemove();
+	}
+
+	NumFunctions -= NumRemoved;
+	TRACE_COUNTER_ADD(TickAggregator_RemovedFunctions, NumRemoved);
+
+	NumPendingRemove = 0;
+}
+
+void FTickAggregatorNativeObjectArray::ReleaseUnusedMemory()
+{
+	for (FTickFunctionGroup& TickFunctionGroup : TickGroupArray)
+	{
+		TickFunctionGroup.ReleaseUnusedMemory();
+	}
+
+	for (const TUniquePtr<FTypedTickFunctionGroupBase>& TypedTickFunctionGroup : TypedTickGroupArray)
+	{
+		TypedTickFunctionGroup->ReleaseUnusedMemory();
+	}
+}
+
+void FAggregatedTickFunctionCollection::Execute(float DeltaTime, const FTickAggregatorFrameContext& FrameContext)
+{
+#if TICK_AGGREGATOR_TRACE_ENABLED
+	if (TraceName.Name.IsEmpty())
+	{
+		TraceName.Name = FString::Printf(TEXT("TickAggregator %s - %s"), *UEnum::GetValueAsString(AssociatedTickingGroup), *UEnum::GetValueAsString(AssociatedTickCategory));
+	}
+#endif
+	TA_TRACE_SCOPE(TraceName);
+
+	// remove required objects before ticking them.
+	RemoveAndDestroyRequiredObjects();
+
+	// tick the objects.
+	TickObjects(DeltaTime, FrameContext);
+}
+
+FTickAggregatorFunctionHandle FAggregatedTickFunction::RegisterNativeFunction(const UObject* Object, const FAggregatedTickDelegate& Function, ETickAggregatorTickCategory::Type Category, const FTickFunctionGroupId TickFunctionGroupName, const FTickFunctionGroupSettings& Settings)
+{
+	using namespace Intax::TA;
+
+	if (!Function.IsBound() || !Object)
+	{
+		return MakeInvalidFunctionHandle();
+	}
+
+	if (Category == ETickAggregatorTickCategory::TC_UNORDERED)
+	{
+		return RegisterUnorderedNativeFunction(Object, Function, Category);
+	}
+
+	FAggregatedTickFunctionCollection* Collection = GetCollectionByCategory(Category);
+	if (!ensure(Collection))
+	{
+		return MakeInvalidFunctionHandle();
+	}
+
+	const FTickAggregatorFunctionHandle Handle = Collection->AddNewNativeFunction(Object, Function, TickFunctionGroupName, Settings);
+	if (Handle.IsValid())
+	{
+		MarkCategoryOccupied(Category);
+	}
+
+	return Handle;
+}
+
+bool FAggregatedTickFunction::RemoveNativeFunction(const FTickAggregatorFunctionHandle& InHandle)
+{
+	check(IsInGameThread());
+
+	const FTickAggregatorFunctionHandle Handle = ConsumeDeferredHandle(InHandle);
+	if (!Handle.IsValid())
+	{
+		// a deferred registration that is still queued is cancelled by ConsumeDeferredHandle(), that's as good as removed.
+		return InHandle.IsDeferred();
+	}
+
+	if (Handle.GetTickCategory() == ETickAggregatorTickCategory::TC_UNORDERED)
+	{
+		return RemoveUnorderedNativeFunction(Handle);
+	}
+
+	FAggregatedTickFunctionCollection* Collection = GetCollectionByCategory(Handle.GetTickCategory());
+	if (!ensure(Collection))
+	{
+		return false;
+	}
+
+	return Collection->AddNewRemoveRequest(Handle);
+}
+
+FTickAggregatorFunctionHandle FAggregatedTickFunction::EnqueueRegisterRequest(const ETickAggregatorTickCategory::Type Category, TUniqueFunction<FTickAggregatorFunctionHandle(FAggregatedTickFunction&)>&& Register)
+{
+	const uint64 Ticket = NextTicket.fetch_add(1, std::memory_order_relaxed);
+	const FTickAggregatorFunctionHandle DeferredHandle = FTickAggregatorFunctionHandle::MakeDeferred(Ticket, Category, AssociatedTickGroup);
+
+	FTickAggregatorPendingRequest Request;
+	Request.Register = MoveTemp(Register);
+	Request.Handle = DeferredHandle;
+	PushPendingRequest(MoveTemp(Request));
+
+	return DeferredHandle;
+}
+
+void FAggregatedTickFunction::EnqueueRemoveRequest(const FTickAggregatorFunctionHandle& InHandle)
+{
+	FTickAggregatorPendingRequest Request;
+	Request.Handle = InHandle;
+	PushPendingRequest(MoveTemp(Request));
+}
+
+void FAggregatedTickFunction::EnqueueRequest(TUniqueFunction<void()>&& Request)
+{
+	FTickAggregatorPendingRequest PendingRequest;
+	PendingRequest.Register = [Request = MoveTemp(Request)](FAggregatedTickFunction&)
+	{
+		Request();
+		return Intax::TA::MakeInvalidFunctionHandle();
+	};
+	PushPendingRequest(MoveTemp(PendingRequest));
+}
+
+void FAggregatedTickFunction::PushPendingRequest(FTickAggregatorPendingRequest&& Request)
+{
+	NumRequestsBeingQueued.fetch_add(1);
+	PendingRequests.Enqueue(MoveTemp(Request));
+	NumRequestsBeingQueued.fetch_sub(1);
+}
+
+void FAggregatedTickFunction::ProcessPendingRequests()
+{
+	check(IsInGameThread());
+
+	ApplyPendingRequests();
+
+	// a ticket is only handed out after it's registration is queued, so cancelled tickets are already in the queue. but a
+	// request that is still being queued hides the ones that are queued after it until it's linked. once nothing is being
+	// queued, draining again sees every cancelled ticket. whatever is left was cancelled after it's registration failed or
+	// the function was already gone, so it can be forgotten. otherwise they're kept until the next time.
+	if (CancelledTickets.Num() > 0 && NumRequestsBeingQueued.load() == 0)
+	{
+		ApplyPendingRequests();
+		CancelledTickets.Reset();
+	}
+
+	if (DeferredHandles.Num() >= DeferredHandlesPruneThreshold)
+	{
+		PruneDeferredHandles();
+	}
+}
+
+void FAggregatedTickFunction::ApplyPendingRequests()
+{
+	FTickAggregatorPendingRequest Request;
+	while (PendingRequests.Dequeue(Request))
+	{
+		if (Request.Register)
+		{
+			if (Request.Handle.IsDeferred() && CancelledTickets.Remove(Request.Handle.GetTicket()) > 0)
+			{
+				continue;
+			}
+
+			const FTickAggregatorFunctionHandle Handle = Request.Register(*this);
+			if (Request.Handle.IsDeferred() && Handle.IsValid())
+			{
+				DeferredHandles.Add(Request.Handle.GetTicket(), Handle);
+			}
+		}
+		else
+		{
+			// producers only get a deferred handle after it's registration is queued, so it's always drained before this.
+			RemoveNativeFunction(Request.Handle);
+		}
+	}
+}
+
+FTickAggregatorFunctionHandle FAggregatedTickFunction::ConsumeDeferredHandle(const FTickAggregatorFunctionHandle& InHandle)
+{
+	if (!InHandle.IsDeferred())
+	{
+		return InHandle;
+	}
+
+	FTickAggregatorFunctionHandle Handle;
+	if (!DeferredHandles.RemoveAndCopyValue(InHandle.GetTicket(), Handle))
+	{
+		// registration might be still in the queue. this can be called from a tick function while collections are ticking,
+		// so queue isn't applied here. only this ticket is cancelled, ProcessPendingRequests() skips it's registration.
+		CancelledTickets.Add(InHandle.GetTicket());
+	}
+
+	return Handle;
+}
+
+bool FAggregatedTickFunction::IsNativeFunctionRegistered(const FTickAggregatorFunctionHandle& InHandle)
+{
+	if (InHandle.GetTickCategory() == ETickAggregatorTickCategory::TC_UNORDERED)
+	{
+		return NativeUnorderedTickFunctions.Contains(InHandle);
+	}
+
+	const FAggregatedTickFunctionCollection* Collection = GetCollectionByCategory(InHandle.GetTickCategory());
+	return Collection && Collection->ContainsNativeFunction(InHandle);
+}
+
+void FAggregatedTickFunction::PruneDeferredHandles()
+{
+	for (TMap<uint64, FTickAggregatorFunctionHandle>::TIterator It = DeferredHandles.CreateIterator(); It; ++It)
+	{
+		// generation of the slot changes once the function is compacted away, so a reused slot isn't mistaken for it.
+		if (!IsNativeFunctionRegistered(It.Value()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	DeferredHandlesPruneThreshold = FMath::Max(DeferredHandles.Num() * 2, Intax::TA::MinDeferredHandlesPruneThreshold);
+}
+
+bool FAggregatedTickFunction::RegisterBlueprintFunction(UObject* Object, ETickAggregatorTickCategory::Type Category)
+{
+	if (!Object)
+	{
+		return false;
+	}
+
+	if (Category == ETickAggregatorTickCategory::TC_UNORDERED)
+	{
+		return RegisterUnorderedBlueprintFunction(Object, Category);
+	}
+
+	FAggregatedTickFunctionCollection* Collection = GetCollectionByCategory(Category);
+	if (!Collection)
+	{
+		return false;
+	}
+
+	const bool bAdded = Collection->AddNewBlueprintFunction(Object);
+	if (bAdded)
+	{
+		MarkCategoryOccupied(Category);
+		TRACE_COUNTER_INCREMENT(TickAggregator_AddedFunctions);
+	}
+
+	return bAdded;
+}
+
+bool FAggregatedTickFunction::RemoveBlueprintFunction(UObject* Object, ETickAggregatorTickCategory::Type Category)
+{
+	if (!Object)
+	{
+		return false;
+	}
+
+	if (Category == ETickAggregatorTickCategory::TC_UNORDERED)
+	{
+		return RemoveUnorderedBlueprintFunction(Object);
+	}
+
+	FAggregatedTickFunctionCollection* Collection = GetCollectionByCategory(Category);
+	if (!Collection)
+	{
+		return false;
+	}
+
+	const bool bRemoved = Collection->AddNewBlueprintRemoveRequest(Object);
+	if (bRemoved)
+	{
+		TRACE_COUNTER_INCREMENT(TickAggregator_RemovedFunctions);
+	}
+
+	return bRemoved;
+}
+
+bool FAggregatedTickFunction::RegisterBlueprintBatchManager(UObject* Manager, UClass* ObjectClass, ETickAggregatorTickCategory::Type Category)
+{
+	if (!Manager || !ObjectClass || !ensureMsgf(Category != ETickAggregatorTickCategory::TC_UNORDERED, TEXT("Blueprint batches can't be registered as unordered.")))
+	{
+		return false;
+	}
+
+	FAggregatedTickFunctionCollection* Collection = GetCollectionByCategory(Category);
+	if (!Collection || !Collection->AddNewBlueprintBatchManager(Manager, ObjectClass))
 	{
-		return BuildNewObjectArrayFor<FTickAggregatedBlueprintObjectArray>(Class).Add(Object, Function) > INDEX_NONE;
+		return false;
 	}
 
-	return false;
+	MarkCategoryOccupied(Category);
+	return true;
 }
 
-#if WITH_EDITOR
-void FAggregatedTickFunctionCollection::DumpTicks(const FString& CategoryName)
+bool FAggregatedTickFunction::RemoveBlueprintBatchManager(UObject* Manager, UClass* ObjectClass, ETickAggregatorTickCategory::Type Category)
 {
-	if (RegisteredNativeObjectsArray.IsEmpty())
-	{
-		TA_LOG(Log, "---");
-		TA_LOG(Log, "%s is empty.", *CategoryName);
-		TA_LOG(Log, "---");
-	}
-	else
+	if (!Manager || !ObjectClass)
 	{
-		TA_LOG(Log, "---");
-		TA_LOG(Log, "%s Tick Functions:", *CategoryName);
-		for (const FTickAggregatorNativeObjectArray& NativeObjects : RegisteredNativeObjectsArray)
-		{
-			const TArray<FTickFunctionGroup>& Array = NativeObjects.Get();
-			for (const FTickFunctionGroup& TickFunctionGroup : Array)
-			{
-				const TArray<FAggregatedTickDelegate>& TickFunctionArray = TickFunctionGroup.Get();
-				for (const FAggregatedTickDelegate& FunctionArray : TickFunctionArray)
-				{
-					TA_LOG(Log, "OBJECT: %s - DEFINITION: %s", *FunctionArray.GetUObject()->GetName(), *TickFunctionGroup.GetDefinition().ToString());
-				}
-			}
-		}
-		TA_LOG(Log, "---");
+		return false;
 	}
+
+	FAggregatedTickFunctionCollection* Collection = GetCollectionByCategory(Category);
+	return Collection ? Collection->RemoveBlueprintBatchManager(Manager, ObjectClass) : false;
 }
-#endif
 
-int32 FTickAggregatorNativeObjectArray::AddNewTickFunction(const FName Identity, const FAggregatedTickDelegate& FunctionPtr)
+bool FAggregatedTickFunction::RegisterBlueprintBatchObject(UObject* Object, ETickAggregatorTickCategory::Type Category)
 {
-	if ((Identity == NAME_None || !FunctionPtr.IsBound()))
+	if (!Object || !ensureMsgf(Category != ETickAggregatorTickCategory::TC_UNORDERED, TEXT("Blueprint batches can't be registered as unordered.")))
 	{
-		return INDEX_NONE;
+		return false;
 	}
 
-	FTickFunctionGroup* FoundTickGroup = FindTickGroupByIdentity(Identity);
-	if (FoundTickGroup)
+	FAggregatedTickFunctionCollection* Collection = GetCollectionByCategory(Category);
+	if (!Collection)
 	{
-		return FoundTickGroup->Add(FunctionPtr);
+		return false;
 	}
-	else
+
+	const bool bAdded = Collection->AddNewBlueprintBatchObject(Object);
+	if (bAdded)
 	{
-		return TickGroupArray.Emplace_GetRef(Identity).Add(FunctionPtr);
+		MarkCategoryOccupied(Category);
+		TRACE_COUNTER_INCREMENT(TickAggregator_AddedFunctions);
 	}
+
+	return bAdded;
 }
 
-void FTickAggregatorNativeObjectArray::RemoveTickFunction(const FName Identity, FAggregatedTickDelegate FunctionPtr)
+bool FAggregatedTickFunction::RemoveBlueprintBatchObject(UObject* Object, ETickAggregatorTickCategory::Type Category)
 {
-	if (!ensure(Identity == NAME_None) || !ensure(FunctionPtr.IsBound()))
+	if (!Object)
 	{
-		return;
+		return false;
 	}
 
-	FTickFunctionGroup* FoundTickGroup = FindTickGroupByIdentity(Identity);
-	if (ensure(FoundTickGroup))
+	FAggregatedTickFunctionCollection* Collection = GetCollectionByCategory(Category);
+	if (!Collection)
 	{
-		FoundTickGroup->RemoveSwap(FunctionPtr);
+		return false;
 	}
-}
 
-FTickFunctionGroup* FTickAggregatorNativeObjectArray::FindTickGroupByIdentity(const FName Identity)
-{
-	auto Predicate = [Identity](const FTickFunctionGroup& TickFunctionGroup) { return TickFunctionGroup.GetDefinition() == Identity; };
-	FTickFunctionGroup* FoundTickGroup = TickGroupArray.FindByPredicate(Predicate);
-	return FoundTickGroup;
+	const bool bRemoved = Collection->AddNewBlueprintBatchRemoveRequest(Object);
+	if (bRemoved)
+	{
+		TRACE_COUNTER_INCREMENT(TickAggregator_RemovedFunctions);
+	}
+
+	return bRemoved;
 }
 
-void FAggregatedTickFunctionCollection::Execute(float DeltaTime)
+FAggregatedTickFunctionCollection* FAggregatedTickFunction::GetCollectionByCategory(ETickAggregatorTickCategory::Type Category)
 {
-	// remove required objects before ticking them.
-	RemoveAndDestroyRequiredObjects();
-
-	// tick the objects.
-	TickObjects(DeltaTime);
+	switch (Category)
+	{
+	case ETickAggregatorTickCategory::TC_ALPHA:   return &Alpha;
+	case ETickAggregatorTickCategory::TC_BRAVO:   return &Bravo;
+	case ETickAggregatorTickCategory::TC_CHARLIE: return &Charlie;
+	case ETickAggregatorTickCategory::TC_DELTA:   return &Delta;
+	case ETickAggregatorTickCategory::TC_ECHO:    return &Echo;
+	case ETickAggregatorTickCategory::TC_FOXTROT: return &Foxtrot;
+	case ETickAggregatorTickCategory::TC_GOLF:    return &Golf;
+	case ETickAggregatorTickCategory::TC_HOTEL:   return &Hotel;
+	case ETickAggregatorTickCategory::TC_INDIA:   return &India;
+	default:
+		return nullptr;
+	}
 }
 
-FTickAggregatorFunctionHandle FAggregatedTickFunction::RegisterNativeFunction(const UObject* Object, const FAggregatedTickDelegate& Function, ETickAggregatorTickCategory::Type Category, const FName TickFunctionGroupName)
+void FAggregatedTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread,
+                                          const FGraphEventRef& MyCompletionGraphEvent)
 {
-	using namespace Intax::TA;
+	SCOPE_CYCLE_COUNTER(STAT_TickAggregator_Tick);
 
-	if (!Function.IsBound() || !Object)
+	// first aggregated tick function of the frame resets the world budget.
+	if (FrameContext.Budget)
 	{
-		return MakeInvalidFunctionHandle();
+		FrameContext.Budget->BeginFrame();
 	}
 
-	switch (Category)
+#if COUNTERSTRACE_ENABLED
+	// counters are per frame, reset them once for all aggregated tick functions of all worlds.
+	static uint64 LastTraceCounterFrame = 0;
+	if (LastTraceCounterFrame != GFrameCounter)
 	{
-	case ETickAggregatorTickCategory::TC_UNORDERED: return RegisterUnorderedNativeFunction(Object, Function, Category);
-	case ETickAggregatorTickCategory::TC_ALPHA:     return Alpha.AddNewNativeFunction(Object, Function, TickFunctionGroupName);
-	case ETickAggregatorTickCategory::TC_BRAVO:     return Bravo.AddNewNativeFunction(Object, Function, TickFunctionGroupName);
-	case ETickAggregatorTickCategory::TC_CHARLIE:   return Charlie.AddNewNativeFunction(Object, Function, TickFunctionGroupName);
-	case ETickAggregatorTickCategory::TC_ECHO:      return Echo.AddNewNativeFunction(Object, Function, TickFunctionGroupName);
-	case ETickAggregatorTickCategory::TC_FOXTROT:   return Foxtrot.AddNewNativeFunction(Object, Function, TickFunctionGroupName);
-	case ETickAggregatorTickCategory::TC_GOLF:      return Golf.AddNewNativeFunction(Object, Function, TickFunctionGroupName);
-	case ETickAggregatorTickCategory::TC_HOTEL:     return Hotel.AddNewNativeFunction(Object, Function, TickFunctionGroupName);
-	case ETickAggregatorTickCategory::TC_INDIA:     return India.AddNewNativeFunction(Object, Function, TickFunctionGroupName);
-	default:
-		checkNoEntry();
-		return MakeInvalidFunctionHandle();
+		LastTraceCounterFrame = GFrameCounter;
+		TRACE_COUNTER_SET(TickAggregator_ExecutedFunctions, 0);
+		TRACE_COUNTER_SET(TickAggregator_AddedFunctions, 0);
+		TRACE_COUNTER_SET(TickAggregator_RemovedFunctions, 0);
 	}
+#endif
 
-}
+	// Destroy interface objects that requested it during last tick.
+	DestroyPendingInterfaceObjects();
 
-bool FAggregatedTickFunction::RemoveNativeFunction(const FTickAggregatorFunctionHandle& InHandle)
-{
-	const ETickAggregatorTickCategory::Type Category = InHandle.GetTickCategory();
+	// Execute ticks in order, empty categories are skipped.
 
-	switch (Category)
+	ExecuteCollection(Alpha, DeltaTime);
+	ExecuteCollection(Bravo, DeltaTime);
+	ExecuteCollection(Charlie, DeltaTime);
+	ExecuteCollection(Delta, DeltaTime);
+
+	ExecuteCollection(Echo, DeltaTime);
+
+	// we tick unordered objects after echo
+	if (IsCategoryOccupied(ETickAggregatorTickCategory::TC_UNORDERED))
 	{
-	case ETickAggregatorTickCategory::TC_ALPHA:   return Alpha.AddNewRemoveRequest(InHandle);
-	case ETickAggregatorTickCategory::TC_BRAVO:   return Bravo.AddNewRemoveRequest(InHandle);
-	case ETickAggregatorTickCategory::TC_CHARLIE: return Charlie.AddNewRemoveRequest(InHandle);
-	case ETickAggregatorTickCategory::TC_ECHO:    return Echo.AddNewRemoveRequest(InHandle);
-	case ETickAggregatorTickCategory::TC_FOXTROT: return Foxtrot.AddNewRemoveRequest(InHandle);
-	case ETickAggregatorTickCategory::TC_GOLF:    return Golf.AddNewRemoveRequest(InHandle);
-	case ETickAggregatorTickCategory::TC_HOTEL:   return Hotel.AddNewRemoveRequest(InHandle);
-	case ETickAggregatorTickCategory::TC_INDIA:   return India.AddNewRemoveRequest(InHandle);
-	default:
-		checkNoEntry();
-		return false;
+		RemovePendingUnorderedTickFunctions();
+		ExecuteUnorderedTickFunctions(DeltaTime);
+
+		if (NativeUnorderedTickFunctions.IsEmpty() && BlueprintUnorderedTickFunctions.IsEmpty())
+		{
+			OccupiedCategories &= ~GetCategoryBit(ETickAggregatorTickCategory::TC_UNORDERED);
+		}
+	}
+
+	ExecuteCollection(Foxtrot, DeltaTime);
+	ExecuteCollection(Golf, DeltaTime);
+	ExecuteCollection(Hotel, DeltaTime);
+	ExecuteCollection(India, DeltaTime);
+
+	// nothing left to tick, tick manager stops queueing us until something registers again.
+	if (OccupiedCategories == 0 && InterfaceObjectsPendingDestroy.IsEmpty())
+	{
+		SetTickFunctionEnable(false);
 	}
 }
 
-bool FAggregatedTickFunction::RegisterBlueprintFunction(UObject* Object, ETickAggregatorTickCategory::Type Category)
+void FAggregatedTickFunction::ExecuteCollection(FAggregatedTickFunctionCollection& Collection, float DeltaTime)
 {
-	if (!Object)
+	const uint32 CategoryBit = GetCategoryBit(Collection.GetTickCategory());
+	if ((OccupiedCategories & CategoryBit) == 0)
 	{
-		return false;
+		return;
 	}
 
-	switch (Category)
+	Collection.Execute(DeltaTime, FrameContext);
+
+	// pending removals were just compacted, so an empty collection stays empty until something registers to it again.
+	// removals requested after this point keep the bit until next tick's compaction.
+	if (Collection.IsEmpty())
 	{
-	case ETickAggregatorTickCategory::TC_UNORDERED: return RegisterUnorderedBlueprintFunction(Object, Category);
-	case ETickAggregatorTickCategory::TC_ALPHA: return Alpha.AddNewBlueprintFunction(Object);
-	case ETickAggregatorTickCategory::TC_BRAVO: return Bravo.AddNewBlueprintFunction(Object);
-	case ETickAggregatorTickCategory::TC_CHARLIE: return Charlie.AddNewBlueprintFunction(Object);
-	case ETickAggregatorTickCategory::TC_ECHO: return Echo.AddNewBlueprintFunction(Object);
-	case ETickAggregatorTickCategory::TC_FOXTROT: return Foxtrot.AddNewBlueprintFunction(Object);
-	case ETickAggregatorTickCategory::TC_GOLF: return Golf.AddNewBlueprintFunction(Object);
-	case ETickAggregatorTickCategory::TC_HOTEL: return Hotel.AddNewBlueprintFunction(Object);
-	case ETickAggregatorTickCategory::TC_INDIA: return India.AddNewBlueprintFunction(Object);
-	default:
-		return false;
-		checkNoEntry();
+		OccupiedCategories &= ~CategoryBit;
 	}
 }
 
-void FAggregatedTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread,
-                                          const FGraphEventRef& MyCompletionGraphEvent)
+void FAggregatedTickFunction::MarkCategoryOccupied(ETickAggregatorTickCategory::Type Category)
 {
-	SCOPE_CYCLE_COUNTER(STAT_TickAggregator_Tick);
+	OccupiedCategories |= GetCategoryBit(Category);
+	EnableTick();
+}
 
-	// Tick legacy
-	Legacy_Tick(DeltaTime);
+void FAggregatedTickFunction::EnableTick()
+{
+	// safe to call before the tick function is registered, it's registered with the state set here.
+	if (!IsTickFunctionEnabled())
+	{
+		SetTickFunctionEnable(true);
+	}
+}
 
-	// Execute ticks in order.
+const TArray<FVector, TInlineAllocator<4>>& FTickAggregatorViewLocations::Get()
+{
+	// views are gathered once per frame for all tick functions of the world, LOD is coarse enough that views moving later in
+	// the frame don't matter.
+	if (FrameNumber == GFrameCounter)
+	{
+		return Locations;
+	}
 
-	Alpha.Execute(DeltaTime);
-	Bravo.Execute(DeltaTime);
-	Charlie.Execute(DeltaTime);
-	Delta.Execute(DeltaTime);
+	FrameNumber = GFrameCounter;
+	Locations.Reset();
 
-	Echo.Execute(DeltaTime);
+	if (!World)
+	{
+		return Locations;
+	}
 
-	// we tick unordered objects after echo
-	RemovePendingUnorderedTickFunctions();
-	ExecuteUnorderedTickFunctions(DeltaTime);
+	for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (PlayerController && PlayerController->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			Locations.Add(ViewLocation);
+		}
+	}
 
-	Foxtrot.Execute(DeltaTime);
-	Golf.Execute(DeltaTime);
-	Hotel.Execute(DeltaTime);
-	India.Execute(DeltaTime);
+	return Locations;
 }
 
 FString FAggregatedTickFunction::DiagnosticMessage()
@@ -410,10 +1614,28 @@ void FAggregatedTickFunction::ExecuteUnorderedTickFunctions(float DeltaTime) con
 {
 	SCOPE_CYCLE_COUNTER(STAT_TickAggregator_Tick);
 
-	for (const FTickFunctionGroup& TickFunctionGroup : NativeUnorderedTickFunctions.Get())
+#if TICK_AGGREGATOR_TRACE_ENABLED
+	if (UnorderedTraceName.Name.IsEmpty())
 	{
-		for (const FAggregatedTickDelegate& FunctionDelegate : TickFunctionGroup.Get())
+		UnorderedTraceName.Name = FString::Printf(TEXT("TickAggregator %s - Unordered"), *UEnum::GetValueAsString(AssociatedTickGroup));
+	}
+#endif
+	TA_TRACE_SCOPE(UnorderedTraceName);
+
+	// indexed loops, same as FAggregatedTickFunctionCollection::TickObjects(). a tick function might register another unordered function.
+	for (int32 TypedGroupIndex = 0; TypedGroupIndex < NativeUnorderedTickFunctions.GetTypedGroups().Num(); ++TypedGroupIndex)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_TickAggregator_TickUnorderedNativeFunctions);
+		NativeUnorderedTickFunctions.GetTypedGroups()[TypedGroupIndex]->Tick(DeltaTime);
+	}
+
+	for (int32 GroupIndex = 0; GroupIndex < NativeUnorderedTickFunctions.Get().Num(); ++GroupIndex)
+	{
+		const FTickFunctionGroup& TickFunctionGroup = NativeUnorderedTickFunctions.Get()[GroupIndex];
+		for (int32 Index = 0; Index < TickFunctionGroup.Get().Num(); ++Index)
 		{
+			const FAggregatedTickDelegate& FunctionDelegate = TickFunctionGroup.Get()[Index].Function;
+
 			SCOPE_CYCLE_COUNTER(STAT_TickAggregator_TickNativeFunctions);
 			SCOPE_CYCLE_COUNTER(STAT_TickAggregator_TickUnorderedNativeFunctions);
 
@@ -428,56 +1650,55 @@ void FAggregatedTickFunction::ExecuteUnorderedTickFunctions(float DeltaTime) con
 		}
 	}
 
-	for (const TPair<TWeakObjectPtr<UObject>, UFunction*>& Pair : BlueprintUnorderedTickFunctions.Get())
+	for (int32 Index = 0; Index < BlueprintUnorderedTickFunctions.Get().Num(); ++Index)
 	{
 		SCOPE_CYCLE_COUNTER(STAT_TickAggregator_TickUnorderedBlueprintFunctions);
 
-		UObject* Object = Pair.Key.Get();
-		UFunction* Function = Pair.Value;
+		UObject* Object = BlueprintUnorderedTickFunctions.Get()[Index].Key;
+		UFunction* Function = BlueprintUnorderedTickFunctions.Get()[Index].Value;
 
-#if TICK_AGGREGATOR_DO_CHECKS
-		if (!ensureMsgf(Object, TEXT("Given object to tick aggregated was invalid!")))
+		if (!Intax::TA::IsTickableBlueprintObject(Object))
 		{
 			continue;
 		}
 
+#if TICK_AGGREGATOR_DO_CHECKS
 		if (!ensureMsgf(Function, TEXT("Given function to tick aggregated was invalid!")))
 		{
 			continue;
 		}
 #endif
 
-		Intax::TA::TickAggregatorDeltaSecondsParam Params(DeltaTime);
-		Object->ProcessEvent(Function, &Params);
+		// unordered objects are of different classes, resolving the layout is only a few loads so it's done per call.
+		FTickAggregatorBlueprintInvoker(Function).Invoke(Object, DeltaTime);
 	}
 }
 
-void FAggregatedTickFunction::RemovePendingUnorderedTickFunctions()
+void FAggregatedTickFunction::RemoveUnreachableObjects()
 {
-	for (const FTickAggregatorFunctionHandle& Handle : NativeUnorderedTickFunctionsPendingRemove)
-	{
-#if TICK_AGGREGATOR_DO_CHECKS
-		if (!ensureMsgf(Handle.IsValid(), TEXT("Given function handle in FunctionsPendingRemove was invalid!")))
-		{
-			continue;
-		}
-#endif
-
-		// @TODO this can be optimized even more. We shouldnt do lookup by predicate at each loop, but maybe we can build another data structure to do faster lookups.
+	Alpha.RemoveUnreachableObjects();
+	Bravo.RemoveUnreachableObjects();
+	Charlie.RemoveUnreachableObjects();
+	Delta.RemoveUnreachableObjects();
+	Echo.RemoveUnreachableObjects();
+	Foxtrot.RemoveUnreachableObjects();
+	Golf.RemoveUnreachableObjects();
+	Hotel.RemoveUnreachableObjects();
+	India.RemoveUnreachableObjects();
+
+	BlueprintUnorderedTickFunctions.RemoveUnreachable();
+	Intax::TA::Private::RemoveUnreachableObjects(BlueprintUnorderedObjectsPendingRemove);
+}
 
-		NativeUnorderedTickFunctions.RemoveTickFunction(Handle.GetIdentity(), Handle.GetTickFunction());
-	}
+void FAggregatedTickFunction::RemovePendingUnorderedTickFunctions()
+{
+	// functions were marked when removal was requested.
+	NativeUnorderedTickFunctions.CompactPendingRemove();
 
-	for (UObject* Object : BlueprintUnorderedObjectsPendingRemove)
+	if (BlueprintUnorderedObjectsPendingRemove.Num() > 0)
 	{
-#if TICK_AGGREGATOR_DO_CHECKS
-		if (!ensureMsgf(Object != nullptr, TEXT("Given UObject in BlueprintObjectsPendingRemove was invalid!")))
-		{
-			continue;
-		}
-#endif
-		UFunction* Function = Object->FindFunctionChecked(Intax::TA::BlueprintTickFunctionName);
-		BlueprintUnorderedTickFunctions.RemoveSwap(Object, Function);
+		BlueprintUnorderedTickFunctions.RemoveAll(BlueprintUnorderedObjectsPendingRemove);
+		BlueprintUnorderedObjectsPendingRemove.Reset();
 	}
 }
 
@@ -491,18 +1712,32 @@ FTickAggregatorFunctionHandle FAggregatedTickFunction::RegisterUnorderedNativeFu
 		return MakeInvalidFunctionHandle();
 	}
 
-	const int32 Index = NativeUnorderedTickFunctions.AddNewTickFunction(DefaultTickFunctionCategory, Function);
-	if (Index != INDEX_NONE)
+	int32 GroupIndex = INDEX_NONE;
+	const FTickAggregatorSlotId Slot = NativeUnorderedTickFunctions.AddNewTickFunction(DefaultTickFunctionGroup, Function, FTickFunctionGroupSettings(), GroupIndex);
+	if (Slot.IsValid())
 	{
-		return MakeFunctionHandle(Index, ETickAggregatorTickCategory::TC_UNORDERED, AssociatedTickGroup, Class, InvalidTickFunctionCategory);
+		MarkCategoryOccupied(ETickAggregatorTickCategory::TC_UNORDERED);
+		return MakeUnorderedFunctionHandle(GroupIndex, false, Slot);
 	}
 
 	return MakeInvalidFunctionHandle();
 }
 
+FTickAggregatorFunctionHandle FAggregatedTickFunction::MakeUnorderedFunctionHandle(const int32 GroupIndex, const bool bTypedFunction, const FTickAggregatorSlotId Slot)
+{
+	const FTickAggregatorFunctionHandle Handle = Intax::TA::MakeFunctionHandle(Slot, 0, GroupIndex, bTypedFunction, ETickAggregatorTickCategory::TC_UNORDERED, AssociatedTickGroup);
+	if (!Handle.IsValid())
+	{
+		// see FAggregatedTickFunctionCollection::MakeNativeFunctionHandle.
+		NativeUnorderedTickFunctions.MarkPendingRemove(GroupIndex, bTypedFunction, Slot);
+	}
+
+	return Handle;
+}
+
 bool FAggregatedTickFunction::RemoveUnorderedNativeFunction(const FTickAggregatorFunctionHandle& FunctionHandle)
 {
-	return NativeUnorderedTickFunctionsPendingRemove.Add(FunctionHandle) > INDEX_NONE;
+	return NativeUnorderedTickFunctions.MarkPendingRemove(FunctionHandle);
 }
 
 bool FAggregatedTickFunction::RegisterUnorderedBlueprintFunction(UObject* Object, ETickAggregatorTickCategory::Type Category)
@@ -515,243 +1750,122 @@ bool FAggregatedTickFunction::RegisterUnorderedBlueprintFunction(UObject* Object
 		return false;
 	}
 
-	const int32 Index = BlueprintUnorderedObjectsPendingRemove.AddUnique(Object);
-	return Index != INDEX_NONE;
-}
-
-/////////////// LEGACY SUPPORT
-
-bool FAggregatedTickFunction::Legacy_AddNewObject(UObject* Object)
-{
-	if (IsValid(Object))
+	UFunction* Function = Class->FindFunctionByName(BlueprintTickFunctionName);
+	if (!ensure(Function))
 	{
-		const UClass* Class = Object->GetClass();
-		if (Intax::TA::DoesObjectImplementBlueprintTickFunction(Object))
-		{
-			if (Intax::TA::DoesBlueprintObjectHaveValidNativeClass(Object))
-			{
-				FTickAggregatorObjectArray& NativeObjectArray = Legacy_NativeAggregatedObjectTickElements.FindOrAdd(Class);
-				FTickAggregatorObjectArray& BlueprintObjectArray = Legacy_BlueprintAggregatedObjectTickElements.FindOrAdd(Class);
-				return NativeObjectArray.AddUnique(Object) != INDEX_NONE && BlueprintObjectArray.AddUnique(Object) != INDEX_NONE;
-			}
-			else
-			{
-				FTickAggregatorObjectArray& BlueprintObjectArray = Legacy_BlueprintAggregatedObjectTickElements.FindOrAdd(Class);
-				return BlueprintObjectArray.AddUnique(Object) != INDEX_NONE;
-			}
-		}
-		else
-		{
-			FTickAggregatorObjectArray& NativeObjectArray = Legacy_NativeAggregatedObjectTickElements.FindOrAdd(Class);
-			return NativeObjectArray.AddUnique(Object) != INDEX_NONE;
-		}
+		return false;
+	}
 
-		checkNoEntry();
+	if (BlueprintUnorderedTickFunctions.AddUnique(Object, Function) == INDEX_NONE)
+	{
+		return false;
 	}
 
-	return false;
+	MarkCategoryOccupied(ETickAggregatorTickCategory::TC_UNORDERED);
+	return true;
 }
 
-bool FAggregatedTickFunction::Legacy_RemoveObject(UObject* Object)
+bool FAggregatedTickFunction::RemoveUnorderedBlueprintFunction(UObject* Object)
 {
-	if (IsValid(Object))
-	{
-		if (Intax::TA::DoesObjectImplementBlueprintTickFunction(Object))
-		{
-			if (Intax::TA::DoesBlueprintObjectHaveValidNativeClass(Object))
-			{
-				return Legacy_BlueprintObjectsToRemove.RemoveSwap(Object) != INDEX_NONE && Legacy_NativeObjectsToRemove.RemoveSwap(Object) != INDEX_NONE;
-			}
-			else
-			{
-				return Legacy_BlueprintObjectsToRemove.RemoveSwap(Object) != INDEX_NONE;
-			}
-		}
-		else
-		{
-			//const UClass* Class = Object->GetClass();
-			//FTickAggregatorObjectArray* ObjectArray = AggregatedObjectTickElements.Find(Class);
-			return Legacy_NativeObjectsToRemove.RemoveSwap(Object) != INDEX_NONE;
-		}
-	}
-	return false;
+	bool bAlreadyPending = false;
+	BlueprintUnorderedObjectsPendingRemove.Add(Object, &bAlreadyPending);
+	return !bAlreadyPending;
 }
 
-bool FAggregatedTickFunction::Legacy_AddNewUnorderedObject(UObject* Object)
+/////////////// INTERFACE OBJECTS
+
+FTickAggregatorInterfaceRegistration FAggregatedTickFunction::RegisterInterfaceObject(UObject* Object, ETickAggregatorTickCategory::Type Category)
 {
-	if (Intax::TA::DoesObjectImplementBlueprintTickFunction(Object))
-	{
-		if (Intax::TA::DoesBlueprintObjectHaveValidNativeClass(Object))
-		{
-			return Legacy_BlueprintUnorderedObjectTickElements.Add(Object) > INDEX_NONE && Legacy_NativeUnorderedObjectTickElements.Add(Object) > INDEX_NONE;
-		}
-		else
-		{
-			return Legacy_BlueprintUnorderedObjectTickElements.Add(Object) > INDEX_NONE;
-		}
-	}
-	else
+	using namespace Intax::TA;
+
+	FTickAggregatorInterfaceRegistration Registration;
+	Registration.Category = Category;
+
+	if (!IsValid(Object))
 	{
-		return Legacy_NativeUnorderedObjectTickElements.Add(Object) > INDEX_NONE;
+		return Registration;
 	}
-}
 
-bool FAggregatedTickFunction::Legacy_RemoveUnorderedObject(UObject* Object)
-{
-	if (Intax::TA::DoesObjectImplementBlueprintTickFunction(Object))
+	// blueprints that implement the tick still tick their native parent if it implements the interface too.
+	const bool bHasBlueprintTick = DoesObjectImplementBlueprintTickFunction(Object);
+	if (!bHasBlueprintTick || DoesBlueprintObjectHaveValidNativeClass(Object))
 	{
-		if (Intax::TA::DoesBlueprintObjectHaveValidNativeClass(Object))
-		{
-			return Legacy_BlueprintUnorderedObjectTickElements.Remove(Object) > 0 && Legacy_NativeUnorderedObjectTickElements.Remove(Object) > 0;
-		}
-		else
+		// resolve the cast once here, delegate calls AggregatedTick() without touching the interface map again.
+		if (ITickAggregatorInterface* Interface = Cast<ITickAggregatorInterface>(Object))
 		{
-			return Legacy_BlueprintUnorderedObjectTickElements.Remove(Object) > 0;
+			FAggregatedTickDelegate Delegate;
+			Delegate.BindWeakLambda(Object, [Interface](float DeltaTime)
+			{
+				Interface->AggregatedTick(DeltaTime);
+			});
+
+			Registration.NativeHandle = RegisterNativeFunction(Object, Delegate, Category, DefaultTickFunctionGroup);
 		}
 	}
-	else
+
+	if (bHasBlueprintTick)
 	{
-		return Legacy_NativeUnorderedObjectTickElements.Remove(Object) > 0;
+		Registration.bBlueprint = RegisterBlueprintFunction(Object, Category);
 	}
 
+	return Registration;
 }
 
-bool FAggregatedTickFunction::Legacy_RemoveObjectOnNextTick(UObject* Object)
+void FAggregatedTickFunction::RemoveInterfaceObject(UObject* Object, const FTickAggregatorInterfaceRegistration& Registration)
 {
-	if (Intax::TA::DoesObjectImplementBlueprintTickFunction(Object))
+	if (Registration.NativeHandle.IsValid())
 	{
-		if (Intax::TA::DoesBlueprintObjectHaveValidNativeClass(Object))
-		{
-			return Legacy_BlueprintObjectsToRemove.Add(Object) != INDEX_NONE && Legacy_NativeObjectsToRemove.Add(Object) != INDEX_NONE;
-		}
-		else
-		{
-			return Legacy_BlueprintObjectsToRemove.Add(Object) > 0;
-		}
+		RemoveNativeFunction(Registration.NativeHandle);
 	}
 
-	return Legacy_NativeObjectsToRemove.Add(Object) != INDEX_NONE;
-}
-
-bool FAggregatedTickFunction::Legacy_RemoveUnorderedObjectOnNextTick(UObject* Object)
-{
-	if (Intax::TA::DoesObjectImplementBlueprintTickFunction(Object))
+	// unreachable blueprint objects are swept by RemoveUnreachableObjects().
+	if (Registration.bBlueprint && Object)
 	{
-		if (Intax::TA::DoesBlueprintObjectHaveValidNativeClass(Object))
-		{
-			return Legacy_BlueprintObjectsToRemoveUnordered.Add(Object) != INDEX_NONE && Legacy_NativeObjectsToRemove.Add(Object) != INDEX_NONE;
-		}
-		else
-		{
-			return Legacy_BlueprintObjectsToRemoveUnordered.Add(Object) != INDEX_NONE;
-		}
+		RemoveBlueprintFunction(Object, Registration.Category);
 	}
-
-	return Legacy_NativeObjectsToRemoveUnordered.Add(Object) != INDEX_NONE;
 }
 
-void FAggregatedTickFunction::Legacy_Tick(float DeltaTime)
+void FAggregatedTickFunction::DestroyInterfaceObjectOnNextTick(UObject* Object, const FTickAggregatorInterfaceRegistration& Registration)
 {
-	SCOPE_CYCLE_COUNTER(STAT_TickAggregator_Tick);
+	// stop ticking right away, destroying is delayed since we might be inside of object's own tick.
+	RemoveInterfaceObject(Object, Registration);
 
+	if (IsValid(Object))
 	{
-		SCOPE_CYCLE_COUNTER(STAT_TickAggregator_RemoveObjects);
-
-		for (UObject* Object : Legacy_NativeObjectsToRemove)
-		{
-			AActor* Actor = Cast<AActor>(Object);
-			if (IsValid(Actor))
-			{
-				Actor->Destroy();
-			}
-			else // if actor already destroyed itself, ignore.
-			{
-				Object->MarkAsGarbage();
-			}
+		InterfaceObjectsPendingDestroy.AddUnique(Object);
 
-			FTickAggregatorObjectArray* ObjectArray = Legacy_NativeAggregatedObjectTickElements.Find(Object->GetClass());
-			ObjectArray->RemoveSwap(Object);
-		}
-		Legacy_NativeObjectsToRemove.Reset();
+		// destroyed on our next tick, even if the object was the last one we tick.
+		EnableTick();
+	}
+}
 
-		for (UObject* Object : Legacy_BlueprintObjectsToRemove)
-		{
-			AActor* Actor = Cast<AActor>(Object);
-			if (IsValid(Actor))
-			{
-				Actor->Destroy();
-			}
-			else // if actor already destroyed itself, ignore.
-			{
-				Object->MarkAsGarbage();
-			}
+void FAggregatedTickFunction::DestroyPendingInterfaceObjects()
+{
+	if (InterfaceObjectsPendingDestroy.IsEmpty())
+	{
+		return;
+	}
 
-			FTickAggregatorObjectArray* ObjectArray = Legacy_NativeAggregatedObjectTickElements.Find(Object->GetClass());
-			ObjectArray->RemoveSwap(Object);
-		}
-		Legacy_BlueprintObjectsToRemove.Reset();
+	SCOPE_CYCLE_COUNTER(STAT_TickAggregator_RemoveObjects);
 
-		for (UObject* Object : Legacy_NativeObjectsToRemoveUnordered)
-		{
-			Legacy_NativeUnorderedObjectTickElements.RemoveSwap(Object);
-		}
-		Legacy_NativeObjectsToRemoveUnordered.Reset();
+	// objects might destroy others from their EndPlay, so iterate a copy.
+	TArray<TWeakObjectPtr<UObject>> ObjectsToDestroy = MoveTemp(InterfaceObjectsPendingDestroy);
 
-		for (UObject* Object : Legacy_BlueprintObjectsToRemoveUnordered)
+	for (const TWeakObjectPtr<UObject>& WeakObject : ObjectsToDestroy)
+	{
+		UObject* Object = WeakObject.Get();
+		if (!IsValid(Object)) // if object already destroyed itself, ignore.
 		{
-			Legacy_BlueprintUnorderedObjectTickElements.RemoveSwap(Object);
+			continue;
 		}
-		Legacy_BlueprintObjectsToRemoveUnordered.Reset();
-	}
 
-	{
+		if (AActor* Actor = Cast<AActor>(Object))
 		{
-			for (const TTuple<TSoftClassPtr<UClass>, FTickAggregatorObjectArray>& ObjectMapPair : Legacy_NativeAggregatedObjectTickElements)
-			{
-				const TArray<TWeakObjectPtr<UObject>>& ObjectArray = ObjectMapPair.Value.Get();
-				for (TWeakObjectPtr<UObject> WeakObject : ObjectArray)
-				{
-					UObject* Object = WeakObject.Get();
-					if (IsValid(Object))
-					{
-						ITickAggregatorInterface* Interface = CastChecked<ITickAggregatorInterface>(Object);
-						Interface->AggregatedTick(DeltaTime);
-					}
-				}
-			}
-
-			for (const TTuple<TSoftClassPtr<UClass>, FTickAggregatorObjectArray>& ObjectMapPair : Legacy_BlueprintAggregatedObjectTickElements)
-			{
-				const TArray<TWeakObjectPtr<UObject>>& ObjectArray = ObjectMapPair.Value.Get();
-				for (TWeakObjectPtr<UObject> WeakObject : ObjectArray)
-				{
-					UObject* Object = WeakObject.Get();
-					if (IsValid(Object))
-					{
-						ITickAggregatorInterface::Execute_BlueprintAggregatedTick(Object, DeltaTime);
-					}
-				}
-			}
+			Actor->Destroy();
 		}
-
+		else
 		{
-
-			for (TWeakObjectPtr<UObject> Object : Legacy_NativeUnorderedObjectTickElements)
-			{
-				if (UObject* ObjectPtr = Object.Get())
-				{
-					ITickAggregatorInterface* Interface = CastChecked<ITickAggregatorInterface>(ObjectPtr);
-					Interface->AggregatedTick(DeltaTime);
-				}
-			}
-
-			for (TWeakObjectPtr<UObject> Object : Legacy_BlueprintUnorderedObjectTickElements)
-			{
-				if (UObject* ObjectPtr = Object.Get())
-				{
-					ITickAggregatorInterface::Execute_BlueprintAggregatedTick(ObjectPtr, DeltaTime);
-				}
-			}
+			Object->MarkAsGarbage();
 		}
 	}
 }
@@ -1,18 +1,32 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "IntaxTickAggregatingPlugin.h"
+#include "TickAggregatorLevelManifest.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/UObjectGlobals.h"
 
 #define LOCTEXT_NAMESPACE "FIntaxTickAggregatingPluginModule"
 
 void FIntaxTickAggregatingPluginModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+#if WITH_EDITOR
+	// record placed actors of levels when they're cooked, so worlds don't need to iterate them on start.
+	ObjectPreSaveHandle = FCoreUObjectDelegates::OnObjectPreSave.AddStatic(&UTickAggregatorLevelManifest::OnObjectPreSave);
+	ObjectPostSaveHandle = FCoreUObjectDelegates::OnObjectPostSave.AddStatic(&UTickAggregatorLevelManifest::OnObjectPostSave);
+#endif
 }
 
 void FIntaxTickAggregatingPluginModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPreSave.Remove(ObjectPreSaveHandle);
+	FCoreUObjectDelegates::OnObjectPostSave.Remove(ObjectPostSaveHandle);
+#endif
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,93 @@
+﻿// Copyright INTAX Interactive, all rights reserved.
+
+#include "TickAggregatorLevelManifest.h"
+#include "TickAggregatorInterface.h"
+#include "TickAggregatorWorldSubsystem.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "UObject/ObjectSaveContext.h"
+
+const UTickAggregatorLevelManifest* UTickAggregatorLevelManifest::Get(const ULevel* Level)
+{
+	// uncooked levels might be edited after they're saved, so their actors are always iterated.
+	if (!FPlatformProperties::RequiresCookedData())
+	{
+		return nullptr;
+	}
+
+	return const_cast<ULevel*>(Level)->GetAssetUserData<UTickAggregatorLevelManifest>();
+}
+
+#if WITH_EDITOR
+void UTickAggregatorLevelManifest::Build(ULevel* Level)
+{
+	TArray<FTickAggregatorManifestActor> Actors;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (!IsValid(Actor) || !Actor->Implements<UTickAggregatorInterface>())
+		{
+			continue;
+		}
+
+		FTickAggregatorManifestActor& Entry = Actors.AddDefaulted_GetRef();
+		Entry.Actor.Object = Actor;
+		Entry.Actor.TickingGroup = UTickAggregatorWorldSubsystem::GetInterfaceTickingGroup(Actor);
+		Entry.Actor.Category = ITickAggregatorInterface::Execute_GetTickCategory(Actor);
+		Entry.bAutoRegister = ITickAggregatorInterface::Execute_ShouldAutomaticallyRegisterActor(Actor);
+		Entry.bUnordered = ITickAggregatorInterface::Execute_ShouldTickAsUnordered(Actor);
+
+		// same components that UTickAggregatorWorldSubsystem::RegisterActor() registers.
+		for (UActorComponent* Component : Actor->GetComponents())
+		{
+			if (IsValid(Component) && Component->Implements<UTickAggregatorInterface>() && ITickAggregatorInterface::Execute_ShouldAutomaticallyRegisterComponent(Actor, Component))
+			{
+				FTickAggregatorManifestObject& ComponentEntry = Entry.Components.AddDefaulted_GetRef();
+				ComponentEntry.Object = Component;
+				ComponentEntry.TickingGroup = UTickAggregatorWorldSubsystem::GetInterfaceTickingGroup(Component);
+				ComponentEntry.Category = ITickAggregatorInterface::Execute_GetTickCategory(Component);
+			}
+		}
+	}
+
+	UTickAggregatorLevelManifest* Manifest = Level->GetAssetUserData<UTickAggregatorLevelManifest>();
+	if (Actors.IsEmpty())
+	{
+		if (Manifest)
+		{
+			Level->RemoveUserDataOfClass(UTickAggregatorLevelManifest::StaticClass());
+		}
+
+		return;
+	}
+
+	if (!Manifest)
+	{
+		Manifest = NewObject<UTickAggregatorLevelManifest>(Level);
+		Level->AddAssetUserData(Manifest);
+	}
+
+	Manifest->Actors = MoveTemp(Actors);
+}
+
+void UTickAggregatorLevelManifest::OnObjectPreSave(UObject* Object, FObjectPreSaveContext SaveContext)
+{
+	// only cooked data uses manifests, levels are saved with their worlds.
+	const UWorld* World = Cast<UWorld>(Object);
+	if (World && IsValid(World->PersistentLevel) && SaveContext.IsCooking())
+	{
+		Build(World->PersistentLevel);
+	}
+}
+
+void UTickAggregatorLevelManifest::OnObjectPostSave(UObject* Object, FObjectPostSaveContext SaveContext)
+{
+	// cooks that run in the editor save the live level, the manifest would be written into the source map on it's next save.
+	const UWorld* World = Cast<UWorld>(Object);
+	if (World && IsValid(World->PersistentLevel) && SaveContext.IsCooking())
+	{
+		World->PersistentLevel->RemoveUserDataOfClass(UTickAggregatorLevelManifest::StaticClass());
+	}
+}
+#endif
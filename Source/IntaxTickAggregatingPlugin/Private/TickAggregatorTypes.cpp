@@ -0,0 +1,96 @@
+﻿// Copyright INTAX Interactive, all rights reserved.
+
+#include "TickAggregatorTypes.h"
+
+namespace Intax::TA::Private
+{
+	/** Registration can come from any thread, so cached ids are guarded. */
+	static FRWLock TickFunctionGroupIdsLock;
+	static TMap<FName, uint32> TickFunctionGroupIdsByName;
+	static TMap<uint32, FName> TickFunctionGroupNamesById;
+
+	/**
+	 * Caches given name and id pair, makes sure two different names didn't end up with the same id. Otherwise their groups
+	 * would silently share their functions, settings and state, so it's fatal wherever checks are enabled.
+	 */
+	static void RegisterTickFunctionGroupName(const FName Name, const uint32 Id)
+	{
+		{
+			FRWScopeLock Lock(TickFunctionGroupIdsLock, SLT_ReadOnly);
+			const uint32* FoundId = TickFunctionGroupIdsByName.Find(Name);
+			if (FoundId && *FoundId == Id)
+			{
+				return;
+			}
+		}
+
+		FRWScopeLock Lock(TickFunctionGroupIdsLock, SLT_Write);
+		TickFunctionGroupIdsByName.Add(Name, Id);
+
+		const FName ExistingName = TickFunctionGroupNamesById.FindOrAdd(Id, Name);
+		if (ExistingName != Name)
+		{
+#if TICK_AGGREGATOR_DO_CHECKS
+			UE_LOG(LogTickAggregator, Fatal, TEXT("Tick function groups %s and %s have the same id, rename one of them."), *ExistingName.ToString(), *Name.ToString());
+#else
+			TA_LOG(Error, "Tick function groups %s and %s have the same id, rename one of them.", *ExistingName.ToString(), *Name.ToString());
+#endif
+		}
+	}
+}
+
+FTickFunctionGroupId::FTickFunctionGroupId(const FName InName)
+{
+	using namespace Intax::TA::Private;
+
+	if (InName.IsNone())
+	{
+		return;
+	}
+
+	{
+		FRWScopeLock Lock(TickFunctionGroupIdsLock, SLT_ReadOnly);
+		if (const uint32* FoundId = TickFunctionGroupIdsByName.Find(InName))
+		{
+			Value = *FoundId;
+			return;
+		}
+	}
+
+	// first time we see this name, hash it the same way as literals so both end up in the same group.
+	const FString NameString = InName.ToString();
+	Value = Hash(*NameString, NameString.Len());
+	RegisterTickFunctionGroupName(InName, Value);
+}
+
+FName FTickFunctionGroupId::ToName() const
+{
+	using namespace Intax::TA::Private;
+
+	if (!IsValid())
+	{
+		return NAME_None;
+	}
+
+	if (Literal)
+	{
+		const FName Name(Literal);
+		RegisterTickFunctionGroupName(Name, Value);
+		return Name;
+	}
+
+	FRWScopeLock Lock(TickFunctionGroupIdsLock, SLT_ReadOnly);
+	const FName* FoundName = TickFunctionGroupNamesById.Find(Value);
+	return FoundName ? *FoundName : NAME_None;
+}
+
+#if TICK_AGGREGATOR_DO_CHECKS
+void FTickFunctionGroupId::CheckCollision() const
+{
+	if (Literal)
+	{
+		// same as ToName(), registering the name of the literal checks it against the other names.
+		Intax::TA::Private::RegisterTickFunctionGroupName(FName(Literal), Value);
+	}
+}
+#endif
@@ -3,6 +3,9 @@
 #include "TickAggregatorWorldSubsystem.h"
 #include "EngineUtils.h"
 #include "TickAggregatorInterface.h"
+#include "TickAggregatorLevelManifest.h"
+
+DECLARE_CYCLE_STAT(TEXT("Tick Aggregator - Level Registration"), STAT_TickAggregator_LevelRegistration, STATGROUP_TickAggregator);
 
 // @todo i dont know if I'm sinning by doing this in here...
 ENUM_RANGE_BY_FIRST_AND_LAST(ETickingGroup, TG_PrePhysics, TG_NewlySpawned);
@@ -10,6 +13,8 @@ ENUM_RANGE_BY_FIRST_AND_LAST(ETickingGroup, TG_PrePhysics, TG_NewlySpawned);
 UTickAggregatorWorldSubsystem::UTickAggregatorWorldSubsystem()
 {
 	bAutomaticallyRegisterAllPlacedActorsOnLevel = true;
+	FrameBudgetMilliseconds = 0.f;
+	LevelRegistrationBudgetMilliseconds = 1.f;
 }
 
 bool UTickAggregatorWorldSubsystem::ShouldCreateSubsystem(UObject* Outer) const
@@ -32,6 +37,12 @@ void UTickAggregatorWorldSubsystem::PostInitialize()
 	FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UTickAggregatorWorldSubsystem::OnLevelAddedToWorld);
 	FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UTickAggregatorWorldSubsystem::OnLevelRemovedFromWorld);
 
+	// blueprint objects are stored as raw pointers, they must be swept before GC purges them.
+	PostReachabilityAnalysisHandle = FCoreUObjectDelegates::PostReachabilityAnalysis.AddUObject(this, &UTickAggregatorWorldSubsystem::OnPostReachabilityAnalysis);
+
+	// objects registered during a frame are registered together at the start of next one.
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UTickAggregatorWorldSubsystem::OnWorldTickStart);
+
 	Intax::TA::Private::SubsystemInstance = this; // set the global reference to subsystem, this is used inside of the macros
 	Intax::TA::Private::CachedGameWorld = CastChecked<UWorld>(GetOuter()); // UWorldSubsystem's outers are their UWorlds.
 	// gamemode calls the world begin play so some games can delay it - we need to handle that case in here.
@@ -48,6 +59,9 @@ void UTickAggregatorWorldSubsystem::PostInitialize()
 
 void UTickAggregatorWorldSubsystem::Deinitialize()
 {
+	FCoreUObjectDelegates::PostReachabilityAnalysis.Remove(PostReachabilityAnalysisHandle);
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+
 	Intax::TA::Private::SubsystemInstance = nullptr;
 	Intax::TA::OnTickAggregatorDeinitialized.Broadcast(this);
 }
@@ -58,52 +72,54 @@ void UTickAggregatorWorldSubsystem::StartTickAggregator()
 	
 	// world should be valid if we are in a world subsystem..
 	check(GetWorld());
+
+	FrameBudget.SetBudget(FrameBudgetMilliseconds);
+	ViewLocations.World = GetWorld();
 	
 	TickFunction_PrePhysics.TickGroup = TG_PrePhysics;
+	TickFunction_PrePhysics.FrameContext.Budget = &FrameBudget;
+	TickFunction_PrePhysics.FrameContext.ViewLocations = &ViewLocations;
 	TickFunction_PrePhysics.RegisterTickFunction(GetWorld()->PersistentLevel);
 	
 	TickFunction_StartPhysics.TickGroup = TG_StartPhysics;
+	TickFunction_StartPhysics.FrameContext.Budget = &FrameBudget;
+	TickFunction_StartPhysics.FrameContext.ViewLocations = &ViewLocations;
 	TickFunction_StartPhysics.RegisterTickFunction(GetWorld()->PersistentLevel);
 	
 	TickFunction_DuringPhysics.TickGroup = TG_DuringPhysics;
+	TickFunction_DuringPhysics.FrameContext.Budget = &FrameBudget;
+	TickFunction_DuringPhysics.FrameContext.ViewLocations = &ViewLocations;
 	TickFunction_DuringPhysics.RegisterTickFunction(GetWorld()->PersistentLevel);
 	
 	TickFunction_EndPhysics.TickGroup = TG_EndPhysics;
+	TickFunction_EndPhysics.FrameContext.Budget = &FrameBudget;
+	TickFunction_EndPhysics.FrameContext.ViewLocations = &ViewLocations;
 	TickFunction_EndPhysics.RegisterTickFunction(GetWorld()->PersistentLevel);
 	
 	TickFunction_PostPhysics.TickGroup = TG_PostPhysics;
+	TickFunction_PostPhysics.FrameContext.Budget = &FrameBudget;
+	TickFunction_PostPhysics.FrameContext.ViewLocations = &ViewLocations;
 	TickFunction_PostPhysics.RegisterTickFunction(GetWorld()->PersistentLevel);
 	
 	TickFunction_PostUpdateWork.TickGroup = TG_PostUpdateWork;
+	TickFunction_PostUpdateWork.FrameContext.Budget = &FrameBudget;
+	TickFunction_PostUpdateWork.FrameContext.ViewLocations = &ViewLocations;
 	TickFunction_PostUpdateWork.RegisterTickFunction(GetWorld()->PersistentLevel);
 	
 	TickFunction_LastDemotable.TickGroup = TG_LastDemotable;
+	TickFunction_LastDemotable.FrameContext.Budget = &FrameBudget;
+	TickFunction_LastDemotable.FrameContext.ViewLocations = &ViewLocations;
 	TickFunction_LastDemotable.RegisterTickFunction(GetWorld()->PersistentLevel);
 
 	// check if we can automatically register placed actors on the level.
 	if (bAutomaticallyRegisterAllPlacedActorsOnLevel)
 	{
 		int32 ImplementedActorCount = 0;
-		// iterate all alive actors in the world and register them automatically if they implement the interface.
-		for (AActor* Actor : TActorRange<AActor>(GetWorld(), AActor::StaticClass(), (EActorIteratorFlags::SkipPendingKill | EActorIteratorFlags::OnlyActiveLevels)))
+		for (ULevel* Level : GetWorld()->GetLevels())
 		{
-			if (IsValid(Actor) && Actor->Implements<UTickAggregatorInterface>())
+			if (IsValid(Level) && Level->bIsVisible)
 			{
-				const ITickAggregatorInterface* Interface = CastChecked<ITickAggregatorInterface>(Actor);
-				if (ITickAggregatorInterface::Execute_ShouldAutomaticallyRegisterActor(Actor))
-				{
-					const bool bWantsUnorderedTick = Interface->ShouldTickAsUnordered();
-					if (bWantsUnorderedTick)
-					{
-						RegisterUnorderedObject(Actor);
-					}
-					else
-					{
-						RegisterActor(Actor);
-					}
-					
-					ImplementedActorCount++;
-				}
+				ImplementedActorCount += RegisterPlacedActors(Level);
 			}
 		}
 
@@ -114,6 +130,29 @@ void UTickAggregatorWorldSubsystem::StartTickAggregator()
 	UE_LOG(LogTemp, Log, TEXT("It took %f milliseconds to PostInitialize %s"), static_cast<float>(FPlatformTime::ToMilliseconds64(E - S)), *GetName());
 }
 
+void UTickAggregatorWorldSubsystem::OnPostReachabilityAnalysis()
+{
+	TickFunction_PrePhysics.RemoveUnreachableObjects();
+	TickFunction_StartPhysics.RemoveUnreachableObjects();
+	TickFunction_DuringPhysics.RemoveUnreachableObjects();
+	TickFunction_EndPhysics.RemoveUnreachableObjects();
+	TickFunction_PostPhysics.RemoveUnreachableObjects();
+	TickFunction_PostUpdateWork.RemoveUnreachableObjects();
+	TickFunction_LastDemotable.RemoveUnreachableObjects();
+
+	// interface objects that are collected without being removed. their blueprint functions are swept above, only native functions are left.
+	for (auto It = RegisteredObjects.CreateIterator(); It; ++It)
+	{
+		const UObject* Object = It.Key().ResolveObjectPtrEvenIfUnreachable();
+		if (!Object || Object->IsUnreachable())
+		{
+			UnregisterObject(nullptr, It.Value(), false);
+			RemoveFromLevelObjects(It.Key(), It.Value().Level);
+			It.RemoveCurrent();
+		}
+	}
+}
+
 bool UTickAggregatorWorldSubsystem::HasAnyDerivedClasses() const
 {
 	TArray<UClass*> OutClasses;
@@ -121,7 +160,7 @@ bool UTickAggregatorWorldSubsystem::HasAnyDerivedClasses() const
 	return OutClasses.Num() > 0;
 }
 
-FTickAggregatorFunctionHandle UTickAggregatorWorldSubsystem::RegisterNativeObject(const UObject* Object, const FAggregatedTickDelegate& Function, const ETickingGroup TickingGroup, ETickAggregatorTickCategory::Type Category, const FName TickFunctionGroup)
+FTickAggregatorFunctionHandle UTickAggregatorWorldSubsystem::RegisterNativeObject(const UObject* Object, const FAggregatedTickDelegate& Function, const ETickingGroup TickingGroup, ETickAggregatorTickCategory::Type Category, const FTickFunctionGroupId TickFunctionGroup, const FTickFunctionGroupSettings& Settings)
 {
 	if (!IsValid(Object))
 	{
@@ -144,7 +183,17 @@ FTickAggregatorFunctionHandle UTickAggregatorWorldSubsystem::RegisterNativeObjec
 		return Intax::TA::MakeInvalidFunctionHandle();
 	}
 
-	return TickFunction->RegisterNativeFunction(Object, Function, Category, TickFunctionGroup);
+	if (!IsInGameThread())
+	{
+		TWeakObjectPtr<const UObject> WeakObject = Object;
+		return TickFunction->EnqueueRegisterRequest(Category, [WeakObject, Function, Category, TickFunctionGroup, Settings](FAggregatedTickFunction& InTickFunction)
+		{
+			const UObject* PendingObject = WeakObject.Get();
+			return PendingObject ? InTickFunction.RegisterNativeFunction(PendingObject, Function, Category, TickFunctionGroup, Settings) : Intax::TA::MakeInvalidFunctionHandle();
+		});
+	}
+
+	return TickFunction->RegisterNativeFunction(Object, Function, Category, TickFunctionGroup, Settings);
 }
 
 bool UTickAggregatorWorldSubsystem::RemoveNativeObject(const FTickAggregatorFunctionHandle& InHandle)
@@ -167,20 +216,19 @@ bool UTickAggregatorWorldSubsystem::RemoveNativeObject(const FTickAggregatorFunc
 	}
 
 	FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByEnum(TickingGroup);
-	if (ensure(FoundTickFunction))
+	if (!ensure(FoundTickFunction))
 	{
 		return false;
 	}
 
-	const bool bUnordered = TickCategory == ETickAggregatorTickCategory::TC_UNORDERED;
-	if (bUnordered)
-	{
-		return FoundTickFunction->RemoveUnorderedNativeFunction(InHandle);
-	}
-	else
+	if (!IsInGameThread())
 	{
-		return FoundTickFunction->RemoveNativeFunction(InHandle);
+		FoundTickFunction->EnqueueRemoveRequest(InHandle);
+		return true;
 	}
+
+	// tick function resolves deferred handles and dispatches unordered ones by itself.
+	return FoundTickFunction->RemoveNativeFunction(InHandle);
 }
 
 bool UTickAggregatorWorldSubsystem::RegisterBlueprintObject(UObject* Object, const ETickAggregatorTickCategory::Type TickCategory, const ETickingGroup TickingGroup)
@@ -196,6 +244,18 @@ bool UTickAggregatorWorldSubsystem::RegisterBlueprintObject(UObject* Object, con
 		return false;
 	}
 
+	if (!IsInGameThread())
+	{
+		TickFunction->EnqueueRequest([TickFunction, WeakObject = TWeakObjectPtr<UObject>(Object), TickCategory]
+		{
+			if (UObject* PendingObject = WeakObject.Get())
+			{
+				TickFunction->RegisterBlueprintFunction(PendingObject, TickCategory);
+			}
+		});
+		return true;
+	}
+
 	return TickFunction->RegisterBlueprintFunction(Object, TickCategory);
 }
 
@@ -212,82 +272,182 @@ bool UTickAggregatorWorldSubsystem::RemoveBlueprintObject(UObject* Object, const
 		return false;
 	}
 
-	//return TickFunction->RegisterBlueprintFunction(Object, TickCategory);
-	return true;
+	if (!IsInGameThread())
+	{
+		TickFunction->EnqueueRequest([TickFunction, WeakObject = TWeakObjectPtr<UObject>(Object), TickCategory]
+		{
+			if (UObject* PendingObject = WeakObject.Get())
+			{
+				TickFunction->RemoveBlueprintFunction(PendingObject, TickCategory);
+			}
+		});
+		return true;
+	}
+
+	return TickFunction->RemoveBlueprintFunction(Object, TickCategory);
 }
 
-void UTickAggregatorWorldSubsystem::RegisterObject(UObject* Object)
+bool UTickAggregatorWorldSubsystem::RegisterBlueprintBatchManager(UObject* Manager, TSubclassOf<UObject> ObjectClass, const ETickAggregatorTickCategory::Type TickCategory, const ETickingGroup TickingGroup)
 {
-	const UWorld* World = GetWorld();
+	if (!IsValid(Manager) || !ObjectClass || TickCategory == ETickAggregatorTickCategory::TC_MAX || TickingGroup == TG_MAX || !Manager->Implements<UTickAggregatorInterface>())
+	{
+		return false;
+	}
 
-	// register the object in next frame because subsystem might be initialized before some actors (which is possible, i guess?)
-	// so we won't have race condition issues. this could be solved with setting a boolean like "bWorldInitialized" etc.
-	// but having a one frame delay affect nothing practically so not really worth the hassle.
-	World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this, Object]
+	FAggregatedTickFunction* TickFunction = GetTickFunctionByEnum(TickingGroup);
+	if (!TickFunction)
 	{
-		if (IsValid(Object) && ensure(Object->Implements<UTickAggregatorInterface>()))
-		{
-			ETickingGroup TickingGroup = TG_MAX;
+		return false;
+	}
 
-			// if object is a component, we need to call it's owner's relevant functions to tweak/override it's settings.
-			UActorComponent* Component = Cast<UActorComponent>(Object);
-			if (Component && Component->GetOwner() && Component->GetOwner()->Implements<UTickAggregatorInterface>())
+	if (!IsInGameThread())
+	{
+		TickFunction->EnqueueRequest([TickFunction, WeakManager = TWeakObjectPtr<UObject>(Manager), WeakClass = TWeakObjectPtr<UClass>(ObjectClass.Get()), TickCategory]
+		{
+			UObject* PendingManager = WeakManager.Get();
+			UClass* PendingClass = WeakClass.Get();
+			if (PendingManager && PendingClass)
 			{
-				if (Component->IsComponentTickEnabled())
-				{
-					Component->SetComponentTickEnabled(false);
-					UE_LOG(LogTemp, Warning, TEXT("Component %s had tick enabled. Prefer using SETUP_AGGREGATED_TICK_CTOR() on owning actor's constructor if it has an owner."), *Component->GetName());
-				}
+				TickFunction->RegisterBlueprintBatchManager(PendingManager, PendingClass, TickCategory);
+			}
+		});
+		return true;
+	}
 
-				// check if actor overrides this component's tick group
-				const ETickingGroup OverrideTickGroup = ITickAggregatorInterface::Execute_OverrideTickingGroupForComponent(Object, Component);
-				if (OverrideTickGroup == TG_MAX) // if it returns TG_MAX that means we can assume actor doesnt override tick group.
-				{
-					// check if component itself returned a specific tick group.
-					const ETickingGroup ComponentTickGroup = ITickAggregatorInterface::Execute_GetTickingGroup(Component);
-					// ensure its not TG_MAX either, if it is, use PrimaryComponentTick's default value. 
-					TickingGroup = ComponentTickGroup != TG_MAX ? ComponentTickGroup : Component->PrimaryComponentTick.TickGroup;
-				}
+	return TickFunction->RegisterBlueprintBatchManager(Manager, ObjectClass, TickCategory);
+}
+
+bool UTickAggregatorWorldSubsystem::RemoveBlueprintBatchManager(UObject* Manager, TSubclassOf<UObject> ObjectClass, const ETickAggregatorTickCategory::Type TickCategory, const ETickingGroup TickingGroup)
+{
+	if (!IsValid(Manager) || !ObjectClass || TickCategory == ETickAggregatorTickCategory::TC_MAX || TickingGroup == TG_MAX)
+	{
+		return false;
+	}
+
+	FAggregatedTickFunction* TickFunction = GetTickFunctionByEnum(TickingGroup);
+	if (!TickFunction)
+	{
+		return false;
+	}
+
+	if (!IsInGameThread())
+	{
+		TickFunction->EnqueueRequest([TickFunction, WeakManager = TWeakObjectPtr<UObject>(Manager), WeakClass = TWeakObjectPtr<UClass>(ObjectClass.Get()), TickCategory]
+		{
+			UObject* PendingManager = WeakManager.Get();
+			UClass* PendingClass = WeakClass.Get();
+			if (PendingManager && PendingClass)
+			{
+				TickFunction->RemoveBlueprintBatchManager(PendingManager, PendingClass, TickCategory);
 			}
-			else // if its not a component, just get ticking group.
+		});
+		return true;
+	}
+
+	return TickFunction->RemoveBlueprintBatchManager(Manager, ObjectClass, TickCategory);
+}
+
+bool UTickAggregatorWorldSubsystem::RegisterBlueprintBatchObject(UObject* Object, const ETickAggregatorTickCategory::Type TickCategory, const ETickingGroup TickingGroup)
+{
+	if (!IsValid(Object) || TickCategory == ETickAggregatorTickCategory::TC_MAX || TickingGroup == TG_MAX)
+	{
+		return false;
+	}
+
+	FAggregatedTickFunction* TickFunction = GetTickFunctionByEnum(TickingGroup);
+	if (!TickFunction)
+	{
+		return false;
+	}
+
+	if (!IsInGameThread())
+	{
+		TickFunction->EnqueueRequest([TickFunction, WeakObject = TWeakObjectPtr<UObject>(Object), TickCategory]
+		{
+			if (UObject* PendingObject = WeakObject.Get())
 			{
-				TickingGroup = ITickAggregatorInterface::Execute_GetTickingGroup(Object);
+				TickFunction->RegisterBlueprintBatchObject(PendingObject, TickCategory);
 			}
+		});
+		return true;
+	}
+
+	return TickFunction->RegisterBlueprintBatchObject(Object, TickCategory);
+}
+
+bool UTickAggregatorWorldSubsystem::RemoveBlueprintBatchObject(UObject* Object, const ETickAggregatorTickCategory::Type TickCategory, const ETickingGroup TickingGroup)
+{
+	if (!IsValid(Object) || TickCategory == ETickAggregatorTickCategory::TC_MAX || TickingGroup == TG_MAX)
+	{
+		return false;
+	}
+
+	FAggregatedTickFunction* TickFunction = GetTickFunctionByEnum(TickingGroup);
+	if (!TickFunction)
+	{
+		return false;
+	}
 
-			const bool bHasValidTickingGroup = TickingGroup != TG_MAX;
-			ensureMsgf(bHasValidTickingGroup, TEXT("Could not receive a valid ticking group for object %s. TG_MAX is considered as invalid ticking group. (Did you forgot to override GetTickingGroup() in interface?)"), *Object->GetName());
-			if (!bHasValidTickingGroup)
+	if (!IsInGameThread())
+	{
+		TickFunction->EnqueueRequest([TickFunction, WeakObject = TWeakObjectPtr<UObject>(Object), TickCategory]
+		{
+			if (UObject* PendingObject = WeakObject.Get())
 			{
-				return;
+				TickFunction->RemoveBlueprintBatchObject(PendingObject, TickCategory);
 			}
+		});
+		return true;
+	}
 
-			FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByEnum(TickingGroup);
-			check(FoundTickFunction);
-			FoundTickFunction->Legacy_AddNewObject(Object);
-			//FoundTickFunction->AddNewObject(Object);
-		}
-	}));
+	return TickFunction->RemoveBlueprintBatchObject(Object, TickCategory);
 }
 
-void UTickAggregatorWorldSubsystem::RemoveObject(UObject* Object)
+void UTickAggregatorWorldSubsystem::RegisterObject(UObject* Object)
 {
+	if (!IsInGameThread())
+	{
+		EnqueueGameThreadRequest(Object, &ThisClass::RegisterObject);
+		return;
+	}
+
 	if (IsValid(Object) && ensure(Object->Implements<UTickAggregatorInterface>()))
 	{
-		FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByObject(Object);
-		check(FoundTickFunction);
-		FoundTickFunction->Legacy_RemoveObject(Object);
+		// register the object in next frame because subsystem might be initialized before some actors (which is possible, i guess?)
+		// so we won't have race condition issues. having a one frame delay affect nothing practically.
+		AddPendingRegistration(Object, false);
 	}
 }
 
+void UTickAggregatorWorldSubsystem::RemoveObject(UObject* Object)
+{
+	if (!IsInGameThread())
+	{
+		EnqueueGameThreadRequest(Object, &ThisClass::RemoveObject);
+		return;
+	}
+
+	RemoveRegisteredObject(Object, false);
+}
+
 void UTickAggregatorWorldSubsystem::OnRegisteredObjectDestroyed(UObject* DestroyedObject)
 {
 	RemoveObject(DestroyedObject);
-
-	// @todo handle new system
 }
 
 void UTickAggregatorWorldSubsystem::RegisterActor(AActor* SpawnedActor)
 {
+	if (!IsInGameThread())
+	{
+		EnqueueGameThreadRequest(SpawnedActor, &ThisClass::RegisterActor);
+		return;
+	}
+
+	if (!IsValid(SpawnedActor))
+	{
+		return;
+	}
+
 	RegisterObject(SpawnedActor);
 
 	// look for actor's components too
@@ -296,104 +456,498 @@ void UTickAggregatorWorldSubsystem::RegisterActor(AActor* SpawnedActor)
 	{
 		if (IsValid(Component))
 		{
-			const bool bImplementsInterface = Component->Implements<UTickAggregatorInterface>();
+			const bool bImplementsInterface = DoesClassImplementInterface(Component->GetClass());
 			const bool bShouldAutoRegisterComponent = bImplementsInterface
 				                                          ? ITickAggregatorInterface::Execute_ShouldAutomaticallyRegisterComponent(SpawnedActor, Component)
 				                                          : false;
 			if (bShouldAutoRegisterComponent)
 			{
 				RegisterObject(Component);
+
+				// remembered by the actor, so components are removed along with it without iterating and querying them again.
+				// looked up after each registration since it might rehash the map. if actor itself wasn't registered, there is
+				// nothing to remember them by and they're removed on their own.
+				if (FTickAggregatorObjectRegistration* ActorRegistration = RegisteredObjects.Find(SpawnedActor))
+				{
+					ActorRegistration->OwnedComponents.AddUnique(Component);
+				}
 			}
 		}
 	}
 
+	BindRegisteredActorDestroyed(SpawnedActor);
+}
+
+void UTickAggregatorWorldSubsystem::BindRegisteredActorDestroyed(AActor* Actor)
+{
 	// check if ondestroyed is already bound, if not add new function.
-	if (!SpawnedActor->OnDestroyed.IsAlreadyBound(this, &UTickAggregatorWorldSubsystem::OnRegisteredActorDestroyed))
+	if (!Actor->OnDestroyed.IsAlreadyBound(this, &UTickAggregatorWorldSubsystem::OnRegisteredActorDestroyed))
 	{
-		SpawnedActor->OnDestroyed.AddUniqueDynamic(this, &UTickAggregatorWorldSubsystem::OnRegisteredActorDestroyed);
+		Actor->OnDestroyed.AddUniqueDynamic(this, &UTickAggregatorWorldSubsystem::OnRegisteredActorDestroyed);
 	}
 }
 
-void UTickAggregatorWorldSubsystem::RemoveActor(AActor* Actor)
+int32 UTickAggregatorWorldSubsystem::RegisterPlacedActors(ULevel* Level)
 {
+	int32 RegisteredActorCount = 0;
+
+	// cooked levels already know their placed actors and how they tick, see UTickAggregatorLevelManifest.
+	if (const UTickAggregatorLevelManifest* Manifest = UTickAggregatorLevelManifest::Get(Level))
+	{
+		for (const FTickAggregatorManifestActor& Entry : Manifest->Actors)
+		{
+			if (Entry.bAutoRegister && RegisterManifestActor(Entry, Entry.bUnordered))
+			{
+				RegisteredActorCount++;
+			}
+		}
+
+		return RegisteredActorCount;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (IsValid(Actor) && DoesClassImplementInterface(Actor->GetClass()) && ITickAggregatorInterface::Execute_ShouldAutomaticallyRegisterActor(Actor))
+		{
+			if (ITickAggregatorInterface::Execute_ShouldTickAsUnordered(Actor))
+			{
+				RegisterUnorderedObject(Actor);
+			}
+			else
+			{
+				RegisterActor(Actor);
+			}
+
+			RegisteredActorCount++;
+		}
+	}
+
+	return RegisteredActorCount;
+}
+
+bool UTickAggregatorWorldSubsystem::RegisterManifestActor(const FTickAggregatorManifestActor& Entry, bool bUnordered)
+{
+	AActor* Actor = Cast<AActor>(Entry.Actor.Object);
 	if (!IsValid(Actor))
 	{
-		return;
+		return false;
 	}
-	
-	RemoveObject(Actor);
 
-	for (UActorComponent* Component : Actor->GetComponents())
+	if (bUnordered)
 	{
-		if (IsValid(Component) && Component->Implements<UTickAggregatorInterface>())
+		return AddPendingRegistration(Actor, true, Entry.Actor.TickingGroup);
+	}
+
+	const bool bRegistered = AddPendingRegistration(Actor, false, Entry.Actor.TickingGroup, Entry.Actor.Category);
+
+	for (const FTickAggregatorManifestObject& Component : Entry.Components)
+	{
+		if (IsValid(Component.Object))
 		{
-			RemoveObject(Component);
+			AddPendingRegistration(Component.Object, false, Component.TickingGroup, Component.Category);
+			RegisteredObjects.FindOrAdd(Actor).OwnedComponents.AddUnique(Component.Object.Get());
 		}
 	}
+
+	BindRegisteredActorDestroyed(Actor);
+	return bRegistered;
+}
+
+void UTickAggregatorWorldSubsystem::RemoveActor(AActor* Actor)
+{
+	if (!IsInGameThread())
+	{
+		EnqueueGameThreadRequest(Actor, &ThisClass::RemoveActor);
+		return;
+	}
+
+	// components registered by RegisterActor() are removed with the actor.
+	RemoveRegisteredObject(Actor, false);
 }
 
 void UTickAggregatorWorldSubsystem::RegisterUnorderedObject(UObject* Object)
 {
+	if (!IsInGameThread())
+	{
+		EnqueueGameThreadRequest(Object, &ThisClass::RegisterUnorderedObject);
+		return;
+	}
+
 	// register it on next frame to let beginplay or other init functions run first.
-	const UWorld* World = GetWorld();
-	World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this, Object]
+	if (IsValid(Object))
 	{
-		if (IsValid(Object))
-		{
-			FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByObject(Object);
-			check(FoundTickFunction);
-			FoundTickFunction->Legacy_AddNewUnorderedObject(Object);
-		}
-	}));
+		AddPendingRegistration(Object, true);
+	}
 }
 
 void UTickAggregatorWorldSubsystem::RemoveUnorderedObject(UObject* Object)
 {
-	if (IsValid(Object))
+	if (!IsInGameThread())
 	{
-		FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByObject(Object);
-		check(FoundTickFunction);
-		FoundTickFunction->Legacy_RemoveUnorderedObject(Object);
+		EnqueueGameThreadRequest(Object, &ThisClass::RemoveUnorderedObject);
+		return;
 	}
+
+	RemoveRegisteredObject(Object, false);
 }
 
 void UTickAggregatorWorldSubsystem::RegisterUnorderedActor(AActor* Actor)
 {
-	if (IsValid(Actor))
+	if (!IsInGameThread())
 	{
-		FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByObject(Actor);
-		check(FoundTickFunction);
-		FoundTickFunction->Legacy_AddNewUnorderedObject(Actor);
+		EnqueueGameThreadRequest(Actor, &ThisClass::RegisterUnorderedActor);
+		return;
+	}
+
+	if (IsValid(Actor) && AddRegistrationRecord(Actor))
+	{
+		ApplyRegistration(Actor, ITickAggregatorInterface::Execute_GetTickingGroup(Actor), ETickAggregatorTickCategory::TC_UNORDERED);
 	}
 }
 
 void UTickAggregatorWorldSubsystem::RemoveUnorderedActor(AActor* Actor)
 {
-	if (IsValid(Actor))
+	if (!IsInGameThread())
 	{
-		FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByObject(Actor);
-		check(FoundTickFunction);
-		FoundTickFunction->Legacy_RemoveUnorderedObject(Actor);
+		EnqueueGameThreadRequest(Actor, &ThisClass::RemoveUnorderedActor);
+		return;
 	}
+
+	RemoveRegisteredObject(Actor, false);
 }
 
 void UTickAggregatorWorldSubsystem::NotifyRemoveRequestDuringTick(UObject* Object)
 {
+	if (!IsInGameThread())
+	{
+		EnqueueGameThreadRequest(Object, &ThisClass::NotifyRemoveRequestDuringTick);
+		return;
+	}
+
 	if (IsValid(Object))
 	{
-		FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByObject(Object);
-		check(FoundTickFunction);
-		FoundTickFunction->Legacy_RemoveObjectOnNextTick(Object);
+		RemoveRegisteredObject(Object, true);
 	}
 }
 
 void UTickAggregatorWorldSubsystem::NotifyRemoveRequestDuringTickUnordered(UObject* Object)
 {
+	if (!IsInGameThread())
+	{
+		EnqueueGameThreadRequest(Object, &ThisClass::NotifyRemoveRequestDuringTickUnordered);
+		return;
+	}
+
 	if (IsValid(Object))
 	{
-		FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByObject(Object);
-		check(FoundTickFunction);
-		FoundTickFunction->Legacy_RemoveUnorderedObjectOnNextTick(Object);
+		RemoveRegisteredObject(Object, true);
+	}
+}
+
+bool UTickAggregatorWorldSubsystem::AddRegistrationRecord(UObject* Object)
+{
+	if (RegisteredObjects.Contains(Object))
+	{
+		return false;
+	}
+
+	FTickAggregatorObjectRegistration& Registration = RegisteredObjects.Add(Object);
+
+	// actors and their components are remembered by their level, so unloading it doesn't need to iterate it's actors.
+	if (const ULevel* Level = Object->GetTypedOuter<ULevel>())
+	{
+		Registration.Level = Level;
+		LevelObjects.FindOrAdd(Level).Add(Object);
+	}
+
+	return true;
+}
+
+bool UTickAggregatorWorldSubsystem::RemoveRegistrationRecord(const FObjectKey& Object, FTickAggregatorObjectRegistration* OutRegistration)
+{
+	FTickAggregatorObjectRegistration Registration;
+	if (!RegisteredObjects.RemoveAndCopyValue(Object, Registration))
+	{
+		return false;
+	}
+
+	RemoveFromLevelObjects(Object, Registration.Level);
+
+	if (OutRegistration)
+	{
+		*OutRegistration = MoveTemp(Registration);
+	}
+
+	return true;
+}
+
+void UTickAggregatorWorldSubsystem::RemoveFromLevelObjects(const FObjectKey& Object, const FObjectKey& Level)
+{
+	if (Level == FObjectKey())
+	{
+		return;
+	}
+
+	if (TSet<FObjectKey>* Objects = LevelObjects.Find(Level))
+	{
+		Objects->Remove(Object);
+		if (Objects->IsEmpty())
+		{
+			LevelObjects.Remove(Level);
+		}
+	}
+}
+
+bool UTickAggregatorWorldSubsystem::DoesClassImplementInterface(const UClass* Class)
+{
+	if (const bool* bCachedImplements = InterfaceClassCache.Find(Class))
+	{
+		return *bCachedImplements;
+	}
+
+	const bool bImplements = Class->ImplementsInterface(UTickAggregatorInterface::StaticClass());
+	InterfaceClassCache.Add(Class, bImplements);
+	return bImplements;
+}
+
+void UTickAggregatorWorldSubsystem::ProcessLevelRegistrationJobs()
+{
+	if (LevelRegistrationJobs.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_TickAggregator_LevelRegistration);
+
+	// reading the clock costs more than checking a cached class, so it's only read every few actors.
+	constexpr int32 ActorsPerTimeCheck = 32;
+	const double EndTime = LevelRegistrationBudgetMilliseconds > 0.f ? FPlatformTime::Seconds() + LevelRegistrationBudgetMilliseconds / 1000.0 : TNumericLimits<double>::Max();
+
+	while (!LevelRegistrationJobs.IsEmpty())
+	{
+		FTickAggregatorLevelRegistrationJob& Job = LevelRegistrationJobs[0];
+		const ULevel* Level = Job.Level.Get();
+		if (IsValid(Level))
+		{
+			while (Job.NextActorIndex < Level->Actors.Num())
+			{
+				AActor* Actor = Level->Actors[Job.NextActorIndex++];
+				if (IsValid(Actor) && DoesClassImplementInterface(Actor->GetClass()))
+				{
+					RegisterActor(Actor);
+				}
+
+				if (Job.NextActorIndex % ActorsPerTimeCheck == 0 && FPlatformTime::Seconds() > EndTime)
+				{
+					return;
+				}
+			}
+		}
+
+		LevelRegistrationJobs.RemoveAt(0);
+	}
+}
+
+bool UTickAggregatorWorldSubsystem::AddPendingRegistration(UObject* Object, bool bUnordered, ETickingGroup TickingGroup, ETickAggregatorTickCategory::Type Category)
+{
+	if (!AddRegistrationRecord(Object))
+	{
+		return false;
+	}
+
+	PendingRegistrations.Add({ Object, bUnordered, TickingGroup, Category });
+	return true;
+}
+
+void UTickAggregatorWorldSubsystem::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		// tick functions are disabled while they're empty, so requests queued from other threads are applied here instead of their tick.
+		TickFunction_PrePhysics.ProcessPendingRequests();
+		TickFunction_StartPhysics.ProcessPendingRequests();
+		TickFunction_DuringPhysics.ProcessPendingRequests();
+		TickFunction_EndPhysics.ProcessPendingRequests();
+		TickFunction_PostPhysics.ProcessPendingRequests();
+		TickFunction_PostUpdateWork.ProcessPendingRequests();
+		TickFunction_LastDemotable.ProcessPendingRequests();
+
+		FlushPendingRegistrations();
+
+		// after the flush, so actors of streamed levels are registered next frame like any other object.
+		ProcessLevelRegistrationJobs();
+	}
+}
+
+void UTickAggregatorWorldSubsystem::FlushPendingRegistrations()
+{
+	if (PendingRegistrations.IsEmpty())
+	{
+		return;
+	}
+
+	// registrations requested while flushing wait for next frame, same as the ones requested during last frame did.
+	const TArray<FTickAggregatorPendingObjectRegistration> Registrations = MoveTemp(PendingRegistrations);
+
+	struct FResolvedRegistration
+	{
+		UObject* Object;
+		const UClass* Class;
+		ETickingGroup TickingGroup;
+		ETickAggregatorTickCategory::Type Category;
+	};
+
+	TArray<FResolvedRegistration> ResolvedRegistrations;
+	ResolvedRegistrations.Reserve(Registrations.Num());
+
+	for (const FTickAggregatorPendingObjectRegistration& Registration : Registrations)
+	{
+		UObject* Object = Registration.Object.Get();
+		if (!IsValid(Object) || !IsRegistrationPending(Object))
+		{
+			continue;
+		}
+
+		// placed actors might already be resolved by the manifest of their level.
+		ETickingGroup TickingGroup = Registration.TickingGroup;
+		if (TickingGroup == TG_MAX)
+		{
+			TickingGroup = Registration.bUnordered ? ITickAggregatorInterface::Execute_GetTickingGroup(Object) : GetInterfaceTickingGroup(Object);
+		}
+
+		const bool bHasValidTickingGroup = TickingGroup != TG_MAX;
+		ensureMsgf(bHasValidTickingGroup, TEXT("Could not receive a valid ticking group for object %s. TG_MAX is considered as invalid ticking group. (Did you forgot to override GetTickingGroup() in interface?)"), *Object->GetName());
+		if (!bHasValidTickingGroup)
+		{
+			RemoveRegistrationRecord(Object);
+			continue;
+		}
+
+		ETickAggregatorTickCategory::Type Category = Registration.bUnordered ? ETickAggregatorTickCategory::TC_UNORDERED : Registration.Category;
+		if (Category == ETickAggregatorTickCategory::TC_MAX)
+		{
+			Category = ITickAggregatorInterface::Execute_GetTickCategory(Object);
+		}
+		ResolvedRegistrations.Add({ Object, Object->GetClass(), TickingGroup, Category });
+	}
+
+	// apply them sorted by tick function, category and class, so inserts into each class array are contiguous.
+	ResolvedRegistrations.Sort([](const FResolvedRegistration& A, const FResolvedRegistration& B)
+	{
+		if (A.TickingGroup != B.TickingGroup)
+		{
+			return A.TickingGroup < B.TickingGroup;
+		}
+
+		if (A.Category != B.Category)
+		{
+			return A.Category < B.Category;
+		}
+
+		return A.Class < B.Class;
+	});
+
+	for (const FResolvedRegistration& Registration : ResolvedRegistrations)
+	{
+		// interface functions of the objects resolved after this one might have removed it.
+		if (IsValid(Registration.Object) && IsRegistrationPending(Registration.Object))
+		{
+			ApplyRegistration(Registration.Object, Registration.TickingGroup, Registration.Category);
+		}
+	}
+}
+
+ETickingGroup UTickAggregatorWorldSubsystem::GetInterfaceTickingGroup(UObject* Object)
+{
+	// if object is a component, we need to call it's owner's relevant functions to tweak/override it's settings.
+	UActorComponent* Component = Cast<UActorComponent>(Object);
+	if (Component && Component->GetOwner() && Component->GetOwner()->Implements<UTickAggregatorInterface>())
+	{
+		// check if actor overrides this component's tick group
+		const ETickingGroup OverrideTickGroup = ITickAggregatorInterface::Execute_OverrideTickingGroupForComponent(Component->GetOwner(), Component);
+		if (OverrideTickGroup != TG_MAX) // if it returns TG_MAX that means we can assume actor doesnt override tick group.
+		{
+			return OverrideTickGroup;
+		}
+
+		// check if component itself returned a specific tick group.
+		const ETickingGroup ComponentTickGroup = ITickAggregatorInterface::Execute_GetTickingGroup(Component);
+		// ensure its not TG_MAX either, if it is, use PrimaryComponentTick's default value. 
+		return ComponentTickGroup != TG_MAX ? ComponentTickGroup : Component->PrimaryComponentTick.TickGroup.GetValue();
+	}
+
+	// if its not a component, just get ticking group.
+	return ITickAggregatorInterface::Execute_GetTickingGroup(Object);
+}
+
+bool UTickAggregatorWorldSubsystem::IsRegistrationPending(UObject* Object) const
+{
+	const FTickAggregatorObjectRegistration* Registration = RegisteredObjects.Find(Object);
+	return Registration && Registration->TickingGroup == TG_MAX;
+}
+
+void UTickAggregatorWorldSubsystem::ApplyRegistration(UObject* Object, ETickingGroup TickingGroup, ETickAggregatorTickCategory::Type Category)
+{
+	FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByEnum(TickingGroup);
+	if (!ensure(FoundTickFunction))
+	{
+		RemoveRegistrationRecord(Object);
+		return;
+	}
+
+	// components of aggregated actors shouldn't tick on their own too.
+	UActorComponent* Component = Cast<UActorComponent>(Object);
+	if (Component && Component->IsComponentTickEnabled() && Component->GetOwner() && DoesClassImplementInterface(Component->GetOwner()->GetClass()))
+	{
+		Component->SetComponentTickEnabled(false);
+		UE_LOG(LogTemp, Warning, TEXT("Component %s had tick enabled. Prefer using SETUP_AGGREGATED_TICK_CTOR() on owning actor's constructor if it has an owner."), *Component->GetName());
+	}
+
+	FTickAggregatorObjectRegistration& Registration = RegisteredObjects.FindOrAdd(Object);
+	Registration.TickingGroup = TickingGroup;
+	Registration.Interface = FoundTickFunction->RegisterInterfaceObject(Object, Category);
+}
+
+void UTickAggregatorWorldSubsystem::RemoveRegisteredObject(UObject* Object, bool bDestroyOnNextTick)
+{
+	FTickAggregatorObjectRegistration Registration;
+	if (!Object || !RemoveRegistrationRecord(Object, &Registration))
+	{
+		return;
+	}
+
+	for (const FObjectKey& ComponentKey : Registration.OwnedComponents)
+	{
+		FTickAggregatorObjectRegistration ComponentRegistration;
+		if (RemoveRegistrationRecord(ComponentKey, &ComponentRegistration))
+		{
+			// components are destroyed with their owner, never on their own.
+			UnregisterObject(ComponentKey.ResolveObjectPtrEvenIfUnreachable(), ComponentRegistration, false);
+		}
+	}
+
+	UnregisterObject(Object, Registration, bDestroyOnNextTick);
+}
+
+void UTickAggregatorWorldSubsystem::UnregisterObject(UObject* Object, const FTickAggregatorObjectRegistration& Registration, bool bDestroyOnNextTick)
+{
+	// registration that is still pending is cancelled by dropping it's record, nothing to remove from tick functions.
+	const bool bPending = Registration.TickingGroup == TG_MAX;
+	if (bPending && !bDestroyOnNextTick)
+	{
+		return;
+	}
+
+	FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByEnum(bPending ? TG_PrePhysics : Registration.TickingGroup);
+	check(FoundTickFunction);
+
+	if (bDestroyOnNextTick)
+	{
+		FoundTickFunction->DestroyInterfaceObjectOnNextTick(Object, Registration.Interface);
+	}
+	else
+	{
+		FoundTickFunction->RemoveInterfaceObject(Object, Registration.Interface);
 	}
 }
 
@@ -410,34 +964,64 @@ void UTickAggregatorWorldSubsystem::OnActorSpawned(AActor* SpawnedActor)
 
 void UTickAggregatorWorldSubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
 {
-	if (IsValid(Level) && IsValid(World))
+	if (!IsValid(Level) || World != GetWorld())
+	{
+		return;
+	}
+
+	// cooked levels already know their actors, so they don't need to be iterated.
+	if (const UTickAggregatorLevelManifest* Manifest = UTickAggregatorLevelManifest::Get(Level))
 	{
-		for (AActor* Actor : Level->Actors)
+		for (const FTickAggregatorManifestActor& Entry : Manifest->Actors)
 		{
-			// @todo this might be quite expensive? 
-			if (IsValid(Actor) && Actor->Implements<UTickAggregatorInterface>())
-			{
-				RegisterActor(Actor);
-			}
+			RegisterManifestActor(Entry, false);
 		}
+
+		return;
 	}
+
+	// actors are registered over next frames within LevelRegistrationBudgetMilliseconds, see ProcessLevelRegistrationJobs().
+	LevelRegistrationJobs.Add({ Level, 0 });
 }
 
 void UTickAggregatorWorldSubsystem::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
 {
-	if (IsValid(Level) && IsValid(World))
+	if (!Level || World != GetWorld())
 	{
-		for (AActor* Actor : Level->Actors)
+		return;
+	}
+
+	LevelRegistrationJobs.RemoveAll([Level](const FTickAggregatorLevelRegistrationJob& Job)
+	{
+		return Job.Level == Level;
+	});
+
+	// only objects registered from this level are visited, instead of every actor of it.
+	TSet<FObjectKey> Objects;
+	if (LevelObjects.RemoveAndCopyValue(Level, Objects))
+	{
+		for (const FObjectKey& Object : Objects)
 		{
-			// @todo this might be quite expensive? 
-			if (IsValid(Actor) && Actor->Implements<UTickAggregatorInterface>())
-			{
-				RemoveActor(Actor);
-			}
+			RemoveRegisteredObject(Object.ResolveObjectPtrEvenIfUnreachable(), false);
 		}
 	}
 }
 
+template<typename ObjectType>
+void UTickAggregatorWorldSubsystem::EnqueueGameThreadRequest(ObjectType* Object, void(UTickAggregatorWorldSubsystem::*Request)(ObjectType*))
+{
+	// ticking group of interface objects can only be queried on game thread, so these go to the queue of an arbitrary tick function. all queues are drained at world tick start.
+	TickFunction_PrePhysics.EnqueueRequest([WeakThis = TWeakObjectPtr<ThisClass>(this), WeakObject = TWeakObjectPtr<ObjectType>(Object), Request]
+	{
+		UTickAggregatorWorldSubsystem* Subsystem = WeakThis.Get();
+		ObjectType* PendingObject = WeakObject.Get();
+		if (Subsystem && PendingObject)
+		{
+			(Subsystem->*Request)(PendingObject);
+		}
+	});
+}
+
 FAggregatedTickFunction* UTickAggregatorWorldSubsystem::GetTickFunctionByObject(UObject* Object)
 {
 	const ETickingGroup TickingGroup = ITickAggregatorInterface::Execute_GetTickingGroup(Object);
@@ -470,6 +1054,12 @@ FAggregatedTickFunction* UTickAggregatorWorldSubsystem::GetTickFunctionByEnum(ET
 	return nullptr;
 }
 
+void UTickAggregatorWorldSubsystem::SetFrameBudget(float InFrameBudgetMilliseconds)
+{
+	FrameBudgetMilliseconds = InFrameBudgetMilliseconds;
+	FrameBudget.SetBudget(FrameBudgetMilliseconds);
+}
+
 void UTickAggregatorWorldSubsystem::PrintAggregatedTickSubscriberCount()
 {
 #if !UE_BUILD_SHIPPING
@@ -502,18 +1092,8 @@ void UTickAggregatorWorldSubsystem::TickAggregatorDumpRegisteredObjects()
 
 void UTickAggregatorWorldSubsystem::OnRegisteredActorDestroyed(AActor* DestroyedActor)
 {
-	if (IsValid(DestroyedActor))
-	{
-		for (UActorComponent* ActorComponent : DestroyedActor->GetComponents())
-		{
-			if (IsValid(ActorComponent) && ActorComponent->Implements<UTickAggregatorInterface>())
-			{
-				OnRegisteredObjectDestroyed(ActorComponent);
-			}
-		}
-	}
-	
-	OnRegisteredObjectDestroyed(DestroyedActor);
+	// components registered by RegisterActor() are remembered by the actor's record, no need to iterate them here.
+	RemoveActor(DestroyedActor);
 }
 
 
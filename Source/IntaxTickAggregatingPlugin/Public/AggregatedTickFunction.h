@@ -4,21 +4,172 @@
 
 #include "CoreMinimal.h"
 #include "TickAggregatorTypes.h"
+#include "Containers/Queue.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include <atomic>
 
-// @todo remove
-struct FTickAggregatorObjectArray
+TRACE_DECLARE_INT_COUNTER_EXTERN(TickAggregator_ExecutedFunctions);
+TRACE_DECLARE_INT_COUNTER_EXTERN(TickAggregator_AddedFunctions);
+TRACE_DECLARE_INT_COUNTER_EXTERN(TickAggregator_RemovedFunctions);
+
+#if TICK_AGGREGATOR_TRACE_ENABLED
+UE_TRACE_CHANNEL_EXTERN(TickAggregatorChannel, INTAXTICKAGGREGATINGPLUGIN_API);
+
+/** Name of a trace scope. Spec id is created on first traced use, so nothing is sent to trace unless the channel is enabled. */
+struct FTickAggregatorTraceScopeName
+{
+	FORCEINLINE uint32 GetSpecId()
+	{
+		if (SpecId == 0)
+		{
+			SpecId = FCpuProfilerTrace::OutputEventType(*Name);
+		}
+
+		return SpecId;
+	}
+
+	FString Name;
+	uint32 SpecId = 0;
+};
+
+/** CPU scope on TickAggregatorChannel, costs only a channel check when the channel is off. */
+struct FTickAggregatorTraceScope
+{
+	FORCEINLINE FTickAggregatorTraceScope(FTickAggregatorTraceScopeName& ScopeName)
+		: bEnabled(UE_TRACE_CHANNELEXPR_IS_ENABLED(TickAggregatorChannel) && UE_TRACE_CHANNELEXPR_IS_ENABLED(CpuChannel))
+	{
+		if (bEnabled)
+		{
+			FCpuProfilerTrace::OutputBeginEvent(ScopeName.GetSpecId());
+		}
+	}
+
+	FORCEINLINE ~FTickAggregatorTraceScope()
+	{
+		if (bEnabled)
+		{
+			FCpuProfilerTrace::OutputEndEvent();
+		}
+	}
+
+private:
+	bool bEnabled;
+};
+
+#define TA_TRACE_SCOPE(ScopeName) FTickAggregatorTraceScope ANONYMOUS_VARIABLE(TickAggregatorTraceScope_)(ScopeName)
+#else
+#define TA_TRACE_SCOPE(ScopeName)
+#endif
+
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+/** Cycle stat and call counter of a class or a group, shown under "stat TickAggregator". */
+struct FTickAggregatorDynamicStats
+{
+	void Initialize(const FString& Name)
+	{
+		CycleStatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_TickAggregator>(Name);
+		CallCountStatId = FDynamicStats::CreateStatIdInt64<FStatGroup_STATGROUP_TickAggregator>(Name + TEXT(" - Calls"));
+	}
+
+	FORCEINLINE void AddCalls(const int32 Count) const
+	{
+		INC_DWORD_STAT_BY_FName(CallCountStatId.GetName(), Count);
+	}
+
+	TStatId CycleStatId;
+	TStatId CallCountStatId;
+};
+#endif
+
+/**
+ * Tick time budget of a world, shared by all FAggregatedTickFunctions of the world. Groups check it before they tick
+ * depending on their ETickFunctionGroupPriority and count their own time against it. Only accessed from game thread.
+ */
+struct FTickAggregatorFrameBudget
 {
 	// FORCEINLINE is fine for this context.
 
-	FORCEINLINE const TArray<TWeakObjectPtr<UObject>>& Get() const { return Array; }
-	FORCEINLINE int32 Add(UObject* Elem) { return Array.Add(Elem); }
-	FORCEINLINE int32 AddUnique(UObject* Elem) { return Array.AddUnique(Elem); }
-	FORCEINLINE int32 Remove(UObject* Elem) { return Array.Remove(Elem); }
-	FORCEINLINE int32 RemoveSwap(UObject* Elem) { return Array.RemoveSwap(Elem, false); }
-	FORCEINLINE void RemoveAtSwap(const int32 Index) { return Array.RemoveAtSwap(Index); }
-	
+	/** Resets spent time once per engine frame, first tick function of the frame that calls this does the reset. */
+	FORCEINLINE void BeginFrame()
+	{
+		if (FrameNumber != GFrameCounter)
+		{
+			FrameNumber = GFrameCounter;
+			SpentCycles = 0;
+		}
+	}
+
+	FORCEINLINE bool CanTick(const ETickFunctionGroupPriority Priority) const
+	{
+		if (BudgetCycles == 0 || Priority == ETickFunctionGroupPriority::Critical)
+		{
+			return true;
+		}
+
+		if (Priority == ETickFunctionGroupPriority::Normal)
+		{
+			return SpentCycles < BudgetCycles * Intax::TA::NormalPriorityBudgetScale;
+		}
+
+		return SpentCycles < BudgetCycles;
+	}
+
+	FORCEINLINE void Consume(const uint64 Cycles)
+	{
+		SpentCycles += Cycles;
+	}
+
+	void SetBudget(const float Milliseconds)
+	{
+		BudgetCycles = Milliseconds > 0.f ? static_cast<uint64>(Milliseconds * 1e-3 / FPlatformTime::GetSecondsPerCycle64()) : 0;
+	}
+
+	/** Zero means unlimited, groups never get deferred. */
+	uint64 BudgetCycles = 0;
+
+	/** Time aggregated groups took in current frame. */
+	uint64 SpentCycles = 0;
+
+	uint64 FrameNumber = 0;
+};
+
+/**
+ * View locations of local players of a world that LOD groups are evaluated against, shared by all FAggregatedTickFunctions
+ * of the world. Gathered by the first LOD group that evaluates in a frame, so worlds without LOD groups never walk their
+ * player controllers. Only accessed from game thread.
+ */
+struct FTickAggregatorViewLocations
+{
+	/** Returns view locations of current frame, empty if there isn't any local player. i.e. on dedicated servers. */
+	const TArray<FVector, TInlineAllocator<4>>& Get();
+
+	UWorld* World = nullptr;
+
 private:
-	TArray<TWeakObjectPtr<UObject>> Array;
+	TArray<FVector, TInlineAllocator<4>> Locations;
+
+	uint64 FrameNumber = MAX_uint64;
+};
+
+/** What FAggregatedTickFunction registered for an ITickAggregatorInterface object, kept by the caller to remove it later without querying the object again. */
+struct FTickAggregatorInterfaceRegistration
+{
+	FTickAggregatorFunctionHandle NativeHandle;
+	ETickAggregatorTickCategory::Type Category = ETickAggregatorTickCategory::TC_MAX;
+	bool bBlueprint = false;
+
+	bool IsRegistered() const { return NativeHandle.IsValid() || bBlueprint; }
+};
+
+/** Per frame data of the world that groups are ticked with. */
+struct FTickAggregatorFrameContext
+{
+	/** View locations of the world, nullptr if tick function isn't registered by a subsystem. LOD isn't re-evaluated then. */
+	FTickAggregatorViewLocations* ViewLocations = nullptr;
+
+	/** Budget of the world, nullptr if tick function isn't registered by a subsystem. */
+	FTickAggregatorFrameBudget* Budget = nullptr;
 };
 
 /**
@@ -38,56 +189,57 @@ private:
  */
 struct FTickFunctionGroup
 {
+	/** Tick function with the group time it was last ticked at, so groups that don't tick every function every frame can
+	 * still pass each function the time passed since it's own last tick. */
+	struct FElement
+	{
+		FElement(const FAggregatedTickDelegate& InFunction, const double InLastTickTime) : Function(InFunction), LastTickTime(InLastTickTime) {}
+
+		FAggregatedTickDelegate Function;
+		double LastTickTime = 0.0;
+
+		/** LOD bucket that this function is in, only used by LOD groups. */
+		ETickAggregatorLOD LOD = ETickAggregatorLOD::Full;
+	};
+
 	FTickFunctionGroup() = delete;
-	FTickFunctionGroup(const FName InIdentity) : Definition(InIdentity) {}
+	FTickFunctionGroup(const FTickFunctionGroupId InIdentity, const FTickFunctionGroupSettings& InSettings = FTickFunctionGroupSettings());
 
 	// FORCEINLINE is fine for this context.
 
-	FORCEINLINE const TArray<FAggregatedTickDelegate>& Get() const
+	FORCEINLINE const TArray<FElement>& Get() const
 	{
-		return TickFunctionDelegates;
+		return TickFunctionDelegates.GetElements();
 	}
 
-	FORCEINLINE int32 Add(const FAggregatedTickDelegate& Elem)
+	FORCEINLINE int32 Num() const
 	{
-		return TickFunctionDelegates.Add(Elem);
+		return TickFunctionDelegates.Num();
 	}
 
-	FORCEINLINE int32 GetIndexOfByKey(const FAggregatedTickDelegate& Elem) const
+	FTickAggregatorSlotId Add(const FAggregatedTickDelegate& Elem);
+
+	/** Marks the function for removal, it's removed on next CompactPendingRemove(). */
+	FORCEINLINE bool MarkPendingRemove(const FTickAggregatorSlotId Id)
 	{
-		const FDelegateHandle ElemHandle = Elem.GetHandle();
-		const auto Predicate = [ElemHandle](const FAggregatedTickDelegate& Other)->bool { return Other.GetHandle() == ElemHandle; };
-		const int32 Index = TickFunctionDelegates.IndexOfByPredicate(Predicate);
-		return Index;
+		return TickFunctionDelegates.MarkPendingRemove(Id);
 	}
 
-	FORCEINLINE int32 AddUnique(const FAggregatedTickDelegate& Elem)
+	FORCEINLINE bool Contains(const FTickAggregatorSlotId Id) const
 	{
-		const int32 Index = GetIndexOfByKey(Elem);
-		return Index == INDEX_NONE ? Add(Elem) : INDEX_NONE;
+		return TickFunctionDelegates.Contains(Id);
 	}
 
-	FORCEINLINE int32 Remove(const FAggregatedTickDelegate& Elem)
+	FORCEINLINE bool HasPendingRemove() const
 	{
-		const int32 Index = GetIndexOfByKey(Elem);
-		if (Index != INDEX_NONE && TickFunctionDelegates.IsValidIndex(Index))
-		{
-			TickFunctionDelegates.RemoveAt(Index);
-			return 1;
-		}
-
-		return 0;
+		return TickFunctionDelegates.HasPendingRemove();
 	}
-	FORCEINLINE int32 RemoveSwap(const FAggregatedTickDelegate Elem)
-	{
-		const int32 Index = GetIndexOfByKey(Elem);
-		if (Index != INDEX_NONE && TickFunctionDelegates.IsValidIndex(Index))
-		{
-			TickFunctionDelegates.RemoveAtSwap(Index);
-			return 1;
-		}
 
-		return 0;
+	int32 CompactPendingRemove();
+
+	FORCEINLINE void ReleaseUnusedMemory()
+	{
+		TickFunctionDelegates.ReleaseUnusedMemory();
 	}
 
 	FORCEINLINE FName GetDefinition() const
@@ -95,174 +247,338 @@ struct FTickFunctionGroup
 		return Definition;
 	}
 
-	// @todo
-	void Tick(float DeltaTime)
+	FORCEINLINE FTickFunctionGroupId GetId() const
+	{
+		return Id;
+	}
+
+	FORCEINLINE bool IsThreadSafe() const
 	{
+		return bThreadSafe;
+	}
 
+	FORCEINLINE ETickFunctionGroupMode GetMode() const
+	{
+		return Mode;
 	}
 
+	/** Called when a new function is added to an existing group. A single non thread-safe function makes whole group serial. */
+	void MergeSettings(const FTickFunctionGroupSettings& InSettings);
+
+	/** Creates the stats and trace scope name of this group, named after the class that owns the group and group's definition. */
+	void InitializeProfiling(const UClass* OwnerClass)
+	{
+#if TICK_AGGREGATOR_DYNAMIC_STATS || TICK_AGGREGATOR_TRACE_ENABLED
+		const FString ProfilingName = FString::Printf(TEXT("%s - %s"), *GetNameSafe(OwnerClass), *Definition.ToString());
+#endif
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+		Stats.Initialize(ProfilingName);
+#endif
+#if TICK_AGGREGATOR_TRACE_ENABLED
+		TraceName.Name = ProfilingName;
+#endif
+	}
+
+	/**
+	 * Executes tick functions of this group depending on it's mode. EveryFrame groups execute all functions, if group is
+	 * thread-safe and big enough, functions are split into batches of Intax::TA::ParallelTickBatchSize and executed via
+	 * ParallelFor. This function doesn't return until every batch is done.
+	 * LOD groups re-evaluate a slice of their functions against given context first, then tick each LOD bucket at it's own rate.
+	 * Group is deferred if frame budget doesn't allow it's priority, deferred time is passed to functions on the next tick.
+	 * Returns count of functions that are executed.
+	 */
+	int32 Tick(float DeltaTime, const FTickAggregatorFrameContext& FrameContext);
+
 protected:
+	/** Executes tick functions depending on the mode of the group. DeltaTime includes the time of the frames group was deferred.
+	 * Returns count of functions that are executed, same as the mode specific tick functions below. */
+	int32 TickByMode(float DeltaTime, const FTickAggregatorFrameContext& FrameContext);
+
+	/** Executes tick functions in [InIndexBegin, InIndexEnd) range on calling thread. */
+	void TickRange(const int32 InIndexBegin, const int32 InIndexEnd, float DeltaTime) const;
+
+	/** Executes functions from the cursor until time budget is consumed or every function is ticked once. */
+	int32 TickTimeSliced();
+
+	/** Executes the next 1/RoundRobinFrameCount of the functions from the cursor. */
+	int32 TickRoundRobin();
+
+	/** Executes the functions that are due this frame, so each function is ticked once every IntervalSeconds. */
+	int32 TickInterval(float DeltaTime);
+
+	/** Executes next Count functions from the cursor, wrapping around the end. Count is clamped to count of functions. */
+	int32 TickFromCursor(const int32 Count);
+
+	/** Re-evaluates LOD of next LODEvaluationsPerFrame functions from the cursor and moves the ones that changed to their new bucket. */
+	void EvaluateLOD(const FTickAggregatorFrameContext& FrameContext);
+
+	/** Ticks full rate bucket every frame, half and quarter rate buckets in 2 and 4 frame strides. Dormant bucket isn't ticked. */
+	int32 TickLODBuckets();
+
+	/** Executes every Stride'th function in [InIndexBegin, InIndexEnd) range, the offset is rotated each frame. */
+	int32 TickLODBucket(const int32 InIndexBegin, const int32 InIndexEnd, const int32 Stride);
+
+	/** Moves the function at given dense index to the bucket of given LOD with one swap per bucket boundary. Returns it's new dense index. */
+	int32 MoveToLOD(const int32 DenseIndex, const ETickAggregatorLOD NewLOD);
+
+	/** Executes the function with the time passed since it's last tick. */
+	FORCEINLINE void TickElement(FElement& Element)
+	{
+		const float ElementDeltaTime = static_cast<float>(GroupTime - Element.LastTickTime);
+		Element.LastTickTime = GroupTime;
+
+#if TICK_AGGREGATOR_DO_CHECKS
+		if (!ensureAlwaysMsgf(Element.Function.IsBound(), TEXT("TickFunctionPtr was not bound to anything?!")))
+		{
+			return;
+		}
+#endif
+
+		Element.Function.Execute(ElementDeltaTime);
+	}
+
 	/**
 	 * Delegates that hold a pointer to same functions
 	 * Delegates get optimized into single function pointer call on shipping build, so it's safe to use them.
+	 * They're kept in a slot map, so they're still tightly packed for the tick loop but handles can find them in O(1).
 	 */
-	TArray<FAggregatedTickDelegate> TickFunctionDelegates;
+	TTickAggregatorSlotMap<FElement> TickFunctionDelegates;
+
+	/** Id of the group, functions are added to groups by this. */
+	FTickFunctionGroupId Id;
 
 	/** User defined identity of this tick function array. i.e. name of the tick group. */
 	FName Definition;
+
+	/** Sum of delta times this group has been ticked with. Functions' own delta times are measured against this. */
+	double GroupTime = 0.0;
+
+	/** Dense index of the function that is ticked first on next frame for modes that don't tick every function every frame,
+	 * or the function that LOD is evaluated first on next frame for LOD groups. */
+	int32 Cursor = 0;
+
+	/** See FTickFunctionGroupSettings::TimeSliceBudgetMicroseconds, converted to cycles once so tick loop doesn't need to. */
+	uint64 TimeSliceBudgetCycles = 0;
+
+	/** See FTickFunctionGroupSettings::RoundRobinFrameCount */
+	int32 RoundRobinFrameCount = 1;
+
+	/** See FTickFunctionGroupSettings::IntervalSeconds */
+	float IntervalSeconds = 0.f;
+
+	/** Fractional count of functions that are due but not ticked yet, carried over to next frame. */
+	double IntervalTickDebt = 0.0;
+
+	/**
+	 * End of full, half and quarter rate buckets in the dense array, dormant bucket ends at the end of the array.
+	 * Functions of a class stay contiguous in each bucket, so each bucket is still a linear loop.
+	 */
+	int32 LODBucketEnds[static_cast<int32>(ETickAggregatorLOD::Dormant)] = {};
+
+	/** Squared max distances of full, half and quarter rate buckets. */
+	double LODDistancesSquared[static_cast<int32>(ETickAggregatorLOD::Dormant)] = {};
+
+	/** See FTickFunctionGroupSettings::LODEvaluationsPerFrame */
+	int32 LODEvaluationsPerFrame = 0;
+
+	/** Rotates the stride offset of half and quarter rate buckets, so they tick a different subset each frame. */
+	uint32 LODFrameCounter = 0;
+
+	/** See FTickFunctionGroupSettings::bUseDistanceLOD */
+	bool bUseDistanceLOD = false;
+
+	/** Frame time that is accumulated while group is deferred by frame budget, passed to EveryFrame functions on the next tick. */
+	float DeferredDeltaTime = 0.f;
+
+	/** Count of consecutive frames this group was deferred, see Intax::TA::MaxDeferredFrames. */
+	int32 DeferredFrameCount = 0;
+
+	/** See FTickFunctionGroupSettings::Priority */
+	ETickFunctionGroupPriority Priority = ETickFunctionGroupPriority::Normal;
+
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+	FTickAggregatorDynamicStats Stats;
+#endif
+
+#if TICK_AGGREGATOR_TRACE_ENABLED
+	FTickAggregatorTraceScopeName TraceName;
+#endif
+
+	/** Whether functions of this group can be executed in parallel. See FTickFunctionGroupSettings::bThreadSafe */
+	bool bThreadSafe = false;
+
+	ETickFunctionGroupMode Mode = ETickFunctionGroupMode::EveryFrame;
 };
 
-struct FTickFunctionGroupInterval : public FTickFunctionGroup
+/**
+ * Base of the tick function groups that know type of their objects and their tick function at compile time.
+ * We pay one virtual call per group instead of one delegate call per object, then typed group calls the member
+ * function directly on a dense array of raw object pointers, so compiler is free to inline the tick function.
+ */
+struct FTypedTickFunctionGroupBase
 {
-	void Tick(float DeltaTime)
+	FTypedTickFunctionGroupBase() = delete;
+	FTypedTickFunctionGroupBase(const FTickFunctionGroupId InIdentity) : Id(InIdentity), Definition(InIdentity.ToName()) {}
+	virtual ~FTypedTickFunctionGroupBase() {}
+
+	virtual void Tick(float DeltaTime) = 0;
+	virtual int32 Num() const = 0;
+	virtual bool MarkPendingRemove(const FTickAggregatorSlotId Id) = 0;
+	virtual bool Contains(const FTickAggregatorSlotId Id) const = 0;
+	virtual bool HasPendingRemove() const = 0;
+	virtual int32 CompactPendingRemove() = 0;
+	virtual void ReleaseUnusedMemory() = 0;
+
+	/** Unique tag per template instantiation, used to find the group with exact same type and function for given identity. */
+	virtual const void* GetTypeTag() const = 0;
+
+	FORCEINLINE FName GetDefinition() const { return Definition; }
+	FORCEINLINE FTickFunctionGroupId GetId() const { return Id; }
+
+	/** See FTickFunctionGroup::InitializeProfiling */
+	void InitializeProfiling(const UClass* OwnerClass)
 	{
-		SpentTime += DeltaTime;
-		if (SpentTime >= Interval)
-		{
-			SpentTime = 0.f;
-			for (const TDelegate<void(float)>& Function : TickFunctionDelegates)
-			{
-				Function.Execute(DeltaTime);
-			}
-		}
+#if TICK_AGGREGATOR_DYNAMIC_STATS || TICK_AGGREGATOR_TRACE_ENABLED
+		const FString ProfilingName = FString::Printf(TEXT("%s - %s"), *GetNameSafe(OwnerClass), *Definition.ToString());
+#endif
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+		Stats.Initialize(ProfilingName);
+#endif
+#if TICK_AGGREGATOR_TRACE_ENABLED
+		TraceName.Name = ProfilingName;
+#endif
 	}
-private:
-	double SpentTime;
-	double Interval;
-};
-
-struct FTickFunctionGroupRoundRobin : public FTickFunctionGroup
-{
 
-	// CountOfTicks / frame
-	// while reach the frame?
-	// then delay?
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+	FORCEINLINE const FTickAggregatorDynamicStats& GetStats() const { return Stats; }
+#endif
 
-	// problems: batch swap indexes
-	// receive new prio from function owners?
+#if TICK_AGGREGATOR_TRACE_ENABLED
+	FORCEINLINE FTickAggregatorTraceScopeName& GetTraceName() { return TraceName; }
+#endif
 
-	void placeholder()
-	{
-		const TArray<TPair<int32, double>> PrioList;
+protected:
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+	FTickAggregatorDynamicStats Stats;
+#endif
 
-		// break up into prios
+#if TICK_AGGREGATOR_TRACE_ENABLED
+	FTickAggregatorTraceScopeName TraceName;
+#endif
 
-		// indexes hold the prio data
-		// distribute elements by their indexes by using movetemp:
-		// LowPrio[i] = MoveTemp(FuncArray[Index])
-	}
+	FTickFunctionGroupId Id;
 
-	void Tick(float DeltaTime)
-	{
-		
-	}
-	
-	struct FRoundRobinIndexRange { int32 X, Y; };
-	TArray<FRoundRobinIndexRange> RoundRobinDistribution;
+	/** User defined identity of this group. i.e. name of the tick group. */
+	FName Definition;
 };
 
-struct FTickFunctionGroupTimeSliced : public FTickFunctionGroup
+/**
+ * Storage of typed groups. Objects are stored as raw pointers, so owners MUST remove themselves from the aggregator
+ * before they're destroyed.
+ */
+template<typename T>
+struct TTypedTickFunctionGroupStorage : public FTypedTickFunctionGroupBase
 {
-	/**
-	 * @brief Helper function to tick objects with a time-budget by range of indexes
-	 * @param InIndexBegin Determines at which index of tick functions we start with
-	 * @param InIndexEnd Determines at which index of tick functions we should exit the while loop
-	 * @param InTimeBudget Max time we can take to tick functions
-	 * @param InDeltaTime Tick delta
-	 * @param OutTimeLeft Time left after we finished while loop
-	 * @param OutIndex Reached index after we finished while loop
-	 */
-	void TickRange(const int32 InIndexBegin, const int32 InIndexEnd, const float InTimeBudget, float InDeltaTime, float& OutTimeLeft, int32& OutIndex)
-	{
-		int32 Index = InIndexBegin;
-		float TimeLeft = InTimeBudget;
+	static_assert(TIsDerivedFrom<T, UObject>::Value, "Typed tick function groups only support UObject types.");
 
-		ensure(Index != INDEX_NONE);
-		ensure(Index < TickFunctionDelegates.Num());
-		ensure(TimeLeft > 0.0);
-		
-		while (TimeLeft > 0.0 && Index <= InIndexEnd)
-		{
-			// time we started this step
-			const double StepStartTime = FPlatformTime::Seconds();
+	using ObjectType = T;
 
-			// access the tick function and execute it
-			FAggregatedTickDelegate& Function = TickFunctionDelegates[Index];
-			Function.Execute(InDeltaTime);
+	TTypedTickFunctionGroupStorage(const FTickFunctionGroupId InIdentity) : FTypedTickFunctionGroupBase(InIdentity) {}
 
-			// time spent to execute the tick function
-			const double StepProcessingTime = FPlatformTime::Seconds() - StepStartTime;
+	// FORCEINLINE is fine for this context.
 
-			// decrement time spent to execute the tick function from time budget
-			TimeLeft -= StepProcessingTime;
-			// increment the index
-			Index++;
-		}
+	FORCEINLINE const TArray<T*>& Get() const { return Objects.GetElements(); }
+	FORCEINLINE FTickAggregatorSlotId Add(T* Object) { return Objects.Emplace(Object); }
 
-		OutTimeLeft = TimeLeft;
-		OutIndex = Index;
-	}
-	
-	void Tick(float DeltaTime)
-	{
-		// total number of tickable functions
-		const int32 FunctionCount = TickFunctionDelegates.Num();
+	virtual int32 Num() const override { return Objects.Num(); }
+	virtual bool MarkPendingRemove(const FTickAggregatorSlotId Id) override { return Objects.MarkPendingRemove(Id); }
+	virtual bool Contains(const FTickAggregatorSlotId Id) const override { return Objects.Contains(Id); }
+	virtual bool HasPendingRemove() const override { return Objects.HasPendingRemove(); }
+	virtual int32 CompactPendingRemove() override { return Objects.CompactPendingRemove(); }
+	virtual void ReleaseUnusedMemory() override { Objects.ReleaseUnusedMemory(); }
+
+protected:
+	TTickAggregatorSlotMap<T*> Objects;
+};
+
+/**
+ * Typed group that calls T::TickFunction(float) on each registered object.
+ * i.e. TTypedTickFunctionGroup<AMyActor, &AMyActor::TickMovement>
+ */
+template<typename T, void(T::*TickFunction)(float)>
+struct TTypedTickFunctionGroup final : public TTypedTickFunctionGroupStorage<T>
+{
+	TTypedTickFunctionGroup(const FTickFunctionGroupId InIdentity) : TTypedTickFunctionGroupStorage<T>(InIdentity) {}
 
-		const int32 MaxIndex = FunctionCount - 1;
+	static const void* StaticTypeTag()
+	{
+		static const uint8 Tag = 0;
+		return &Tag;
+	}
 
-		// cache at which index we began this frame 
-		const int32 PreviousIndexBegin = IndexBegin;
-		
-		float TimeLeft;
-		int32 Index;
-		TickRange(IndexBegin, MaxIndex, TimeLimit, DeltaTime, TimeLeft, Index);
+	virtual const void* GetTypeTag() const override { return StaticTypeTag(); }
 
-		// if we haven't consumed all of our time budget but we encountered of the function index to execute..
-		if (TimeLeft > 0.0 && Index < FunctionCount)
+	virtual void Tick(float DeltaTime) override
+	{
+		// indexed loop, a tick function might register a new object into this group and reallocate the elements.
+		// objects that are added while ticking are ticked on the next frame.
+		const int32 Count = this->Objects.Num();
+		for (int32 Index = 0; Index < Count; ++Index)
 		{
-			// check if our begin index was zero or not - if it wasnt zero, that means previous frame we skipped
-			// this frame's updates, so we can roll index back and update until reach the PreviousIndexBegin 
-			if (PreviousIndexBegin != 0)
+			T* Object = this->Objects.GetElements()[Index];
+#if TICK_AGGREGATOR_DO_CHECKS
+			if (!ensureMsgf(IsValid(Object), TEXT("Object in typed tick group was invalid, did owner forget to remove it's handle?")))
 			{
-				float SecondTimeLeft;
-				int32 SecondIndex;
-				TickRange(0, PreviousIndexBegin, DeltaTime, TimeLeft, SecondTimeLeft, SecondIndex);
-				// at this point we can not ever tick the range again - we either reached the max function count or consumed our budged
-				// if we consumed our budget:
-				if (SecondIndex < MaxIndex)
-				{
-					// save the index we managed to reach in second iteration
-					IndexBegin = SecondIndex;
-				}
-				else // if we reached the max function index:
-				{
-					// roll back to first index
-					IndexBegin = 0;
-				}
+				continue;
 			}
+#endif
+
+			(Object->*TickFunction)(DeltaTime);
 		}
-		// if we consumed all of our time budget but couldnt tick all possible functions, set next frame's IndexBegin
-		// to currently reached index, so next frame will continue from where we left.
-		else if (TimeLeft <= 0.0 && Index < MaxIndex)
-		{
-			IndexBegin = Index;
-		}
-		// if we both consumed our time budget and managed to tick all elements, then yay... just set IndexBegin
-		// to zero so we will tick elements from start next frame.
-		else if (TimeLeft <= 0.0 && Index >= FunctionCount)
-		{
-			IndexBegin = 0;
-		}
-		else
+	}
+};
+
+/**
+ * Batch group that calls a single static function once per frame with all registered objects of the class.
+ * Useful for data oriented classes that want to run their own loops over the objects (SIMD, prefetching etc.) instead of
+ * paying per object call overhead. i.e. TBatchTickFunctionGroup<AMyProjectile, &AMyProjectile::BatchTick>
+ * where BatchTick is "static void BatchTick(TArrayView<AMyProjectile* const> Objects, float DeltaTime)"
+ * The batch function receives a snapshot of the objects, so it can register new objects into the same group while it
+ * runs (i.e. a projectile spawning a projectile). Those objects are part of the next frame's batch.
+ */
+template<typename T, void(*BatchTickFunction)(TArrayView<T* const>, float)>
+struct TBatchTickFunctionGroup final : public TTypedTickFunctionGroupStorage<T>
+{
+	TBatchTickFunctionGroup(const FTickFunctionGroupId InIdentity) : TTypedTickFunctionGroupStorage<T>(InIdentity) {}
+
+	static const void* StaticTypeTag()
+	{
+		static const uint8 Tag = 0;
+		return &Tag;
+	}
+
+	virtual const void* GetTypeTag() const override { return StaticTypeTag(); }
+
+	virtual void Tick(float DeltaTime) override
+	{
+		if (this->Objects.Num() > 0)
 		{
-			// we probably covered every situation already - code shouldnt reach to this place
-			checkNoEntry();
+			// registering into this group reallocates the elements, so batch function walks a copy instead of the storage.
+			Snapshot.Reset();
+			Snapshot.Append(this->Objects.GetElements());
+			BatchTickFunction(TArrayView<T* const>(Snapshot), DeltaTime);
 		}
 	}
-	
+
+	virtual void ReleaseUnusedMemory() override
+	{
+		TTypedTickFunctionGroupStorage<T>::ReleaseUnusedMemory();
+		Snapshot.Empty();
+	}
+
 private:
-	double TimeLimit = 0.0;
-	int32 IndexBegin = 0;
+	/** Copy of the objects that is passed to the batch function, kept around to reuse it's allocation. */
+	TArray<T*> Snapshot;
 };
 
 /**
@@ -273,21 +589,89 @@ struct FTickAggregatorNativeObjectArray
 	friend struct FAggregatedTickFunctionCollection;
 
 	FTickAggregatorNativeObjectArray() {}
-	FTickAggregatorNativeObjectArray(TSubclassOf<UObject> InClassType) : ClassType(InClassType) {}
+	FTickAggregatorNativeObjectArray(TSubclassOf<UObject> InClassType) : ClassType(InClassType)
+	{
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+		Stats.Initialize(GetNameSafe(InClassType));
+#endif
+#if TICK_AGGREGATOR_TRACE_ENABLED
+		TraceName.Name = GetNameSafe(InClassType);
+#endif
+	}
+
+	/**
+	 * Adds given function to the group with given identity, creates the group if it doesn't exist.
+	 * Returns the slot of the function in the group and writes the index of the group to OutGroupIndex.
+	 */
+	FTickAggregatorSlotId AddNewTickFunction(const FTickFunctionGroupId Identity, const FAggregatedTickDelegate& FunctionPtr, const FTickFunctionGroupSettings& Settings, int32& OutGroupIndex);
+
+	/** Adds given object to the typed group of GroupType with given identity, creates the group if it doesn't exist. */
+	template<typename GroupType>
+	FTickAggregatorSlotId AddNewTypedTickFunction(const FTickFunctionGroupId Identity, typename GroupType::ObjectType* Object, int32& OutGroupIndex)
+	{
+		if (!Identity.IsValid() || !Object)
+		{
+			return FTickAggregatorSlotId();
+		}
+
+		const FTypedTickGroupKey Key(Identity.GetValue(), GroupType::StaticTypeTag());
+		if (const int32* FoundGroupIndex = TypedTickGroupIndices.Find(Key))
+		{
+			OutGroupIndex = *FoundGroupIndex;
+#if TICK_AGGREGATOR_DO_CHECKS
+			Identity.CheckCollision();
+#endif
+		}
+		else
+		{
+			OutGroupIndex = TypedTickGroupArray.Emplace(MakeUnique<GroupType>(Identity));
+			TypedTickGroupIndices.Add(Key, OutGroupIndex);
+
+			TypedTickGroupArray[OutGroupIndex]->InitializeProfiling(ClassType);
+		}
+
+		const FTickAggregatorSlotId Slot = static_cast<GroupType&>(*TypedTickGroupArray[OutGroupIndex]).Add(Object);
+		++NumFunctions;
+		TRACE_COUNTER_INCREMENT(TickAggregator_AddedFunctions);
+		return Slot;
+	}
 
-	int32 AddNewTickFunction(const FName Identity, const FAggregatedTickDelegate& FunctionPtr);
-	void RemoveTickFunction(const FName Identity, FAggregatedTickDelegate FunctionPtr);
+	/** Marks the function that given handle points to for removal in O(1). Returns false if handle was stale or already marked. */
+	bool MarkPendingRemove(const FTickAggregatorFunctionHandle& Handle);
+	bool MarkPendingRemove(const int32 GroupIndex, const bool bTypedFunction, const FTickAggregatorSlotId Slot);
+
+	/** True if the function that given handle points to is still registered, including the ones that are marked for removal. */
+	bool Contains(const FTickAggregatorFunctionHandle& Handle) const;
+
+	/** Compacts every group that has marked functions, one linear pass per group. */
+	void CompactPendingRemove();
+
+	/** Frees the storage of all groups, used when this class array becomes empty. */
+	void ReleaseUnusedMemory();
 
 	// FORCEINLINE is fine for this context.
 
-	FORCEINLINE const TArray<FTickFunctionGroup>& Get() const { return TickGroupArray; }
+	FORCEINLINE const TIndirectArray<FTickFunctionGroup>& Get() const { return TickGroupArray; }
+	FORCEINLINE TIndirectArray<FTickFunctionGroup>& Get() { return TickGroupArray; }
+	FORCEINLINE const TArray<TUniquePtr<FTypedTickFunctionGroupBase>>& GetTypedGroups() const { return TypedTickGroupArray; }
+	FORCEINLINE bool IsEmpty() const { return NumFunctions == 0; }
+	FORCEINLINE int32 Num() const { return NumFunctions; }
+	FORCEINLINE bool HasPendingRemove() const { return NumPendingRemove > 0; }
 
 	FORCEINLINE TSubclassOf<UObject> GetClassType() const { return ClassType; }
 	FORCEINLINE bool IsA(const TSubclassOf<UObject> Class) const { return Class == ClassType; }
 
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+	FORCEINLINE const FTickAggregatorDynamicStats& GetStats() const { return Stats; }
+#endif
+
+#if TICK_AGGREGATOR_TRACE_ENABLED
+	FORCEINLINE FTickAggregatorTraceScopeName& GetTraceName() { return TraceName; }
+#endif
+
 	friend bool operator==(const FTickAggregatorNativeObjectArray& Lhs, const FTickAggregatorNativeObjectArray& RHS)
 	{
-		return Lhs.ClassType == RHS.ClassType && Lhs.TickGroupArray.Num() == RHS.TickGroupArray.Num();
+		return Lhs.ClassType == RHS.ClassType && Lhs.TickGroupArray.Num() == RHS.TickGroupArray.Num() && Lhs.TypedTickGroupArray.Num() == RHS.TypedTickGroupArray.Num();
 	}
 
 	friend bool operator!=(const FTickAggregatorNativeObjectArray& Lhs, const FTickAggregatorNativeObjectArray& RHS)
@@ -296,46 +680,92 @@ struct FTickAggregatorNativeObjectArray
 	}
 
 protected:
-	FTickFunctionGroup* FindTickGroupByIdentity(const FName Identity);
+	/** Typed groups are unique per id and per template instantiation. */
+	using FTypedTickGroupKey = TPair<uint32, const void*>;
+
+	/**
+	 * Groups are never removed from the arrays, even if they're empty. Handles store the index of their group, and count of
+	 * groups per class is tiny anyways. Tick loop skips empty groups.
+	 *
+	 * Groups are heap allocated, so a group being ticked stays in place when one of it's functions adds a new group to the class.
+	 */
+	TIndirectArray<FTickFunctionGroup> TickGroupArray;
+
+	/** Groups that call their tick functions directly, they're ticked after delegate groups of the same class. */
+	TArray<TUniquePtr<FTypedTickFunctionGroupBase>> TypedTickGroupArray;
+
+	/** Group id -> index in TickGroupArray. */
+	TMap<uint32, int32> TickGroupIndices;
+
+	/** Group id and type tag -> index in TypedTickGroupArray. */
+	TMap<FTypedTickGroupKey, int32> TypedTickGroupIndices;
+
+	/** Count of functions in all groups of this class, including the ones that are marked for removal. */
+	int32 NumFunctions = 0;
+
+	/** Count of functions that are marked for removal but not compacted yet. */
+	int32 NumPendingRemove = 0;
 
-	TArray<FTickFunctionGroup> TickGroupArray;
 	TSubclassOf<UObject> ClassType;
+
+#if TICK_AGGREGATOR_DYNAMIC_STATS
+	/** Covers all groups of this class, typed ones included. */
+	FTickAggregatorDynamicStats Stats;
+#endif
+
+#if TICK_AGGREGATOR_TRACE_ENABLED
+	FTickAggregatorTraceScopeName TraceName;
+#endif
 };
 
-struct FTickFunctionNativeRoundRobinGroup : public FTickAggregatorNativeObjectArray
+/**
+ * Blueprint object and it's tick function. Object is stored raw so tick loops don't resolve a weak pointer per object, entries of
+ * collected objects are swept in bulk right after reachability analysis. See FAggregatedTickFunction::RemoveUnreachableObjects().
+ */
+using FTickAggregatorBlueprintElement = TPair<UObject*, UFunction*>;
+
+namespace Intax::TA
 {
-	FTickFunctionNativeRoundRobinGroup(TSubclassOf<UObject> InClassType, const uint64 FrameDelay)
-		: FTickAggregatorNativeObjectArray(InClassType), FrameDelay(FrameDelay), CurrentFrameIndex(0), CurrentGroupIndex(0), CurrentDelta(0)
+	/** Destroyed objects stay in the arrays until next GC. Garbage flag is mirrored on the object itself, so this doesn't touch the global object array. */
+	FORCEINLINE bool IsTickableBlueprintObject(const UObject* Object)
 	{
+		return !Object->HasAnyFlags(RF_MirroredGarbage);
 	}
+}
 
-	void Update(float DeltaSeconds)
-	{
-		check(CurrentFrameIndex == 0 || (CurrentFrameIndex > 0 || CurrentFrameIndex <= FrameDelay));
+struct FTickAggregatedBlueprintObjectArray;
 
-		// update this frame
-		CurrentFrameIndex++;
-		CurrentDelta =+ DeltaSeconds;
-		if (UNLIKELY(++CurrentFrameIndex == FrameDelay))
-		{
-			check(TickGroupArray.IsValidIndex(CurrentGroupIndex));
+/**
+ * Calls BlueprintAggregatedTick(float) of a blueprint without going through UObject::ProcessEvent(). Since the signature is
+ * fixed, layout of the parameters is resolved once from the UFunction, then each call only writes DeltaSeconds and runs the script.
+ * Functions that need anything else ProcessEvent() handles (RPCs, native implementations, locals that need construction)
+ * fall back to ProcessEvent().
+ */
+struct FTickAggregatorBlueprintInvoker
+{
+	FTickAggregatorBlueprintInvoker() {}
+	explicit FTickAggregatorBlueprintInvoker(UFunction* InFunction);
 
-			// tick this group
-			FTickFunctionGroup& CurrentTickFunctionGroup = TickGroupArray[CurrentGroupIndex];
-			CurrentTickFunctionGroup.Tick(CurrentDelta);
+	FORCEINLINE bool IsBound() const { return Function != nullptr; }
 
-			// reset the variables
-			CurrentFrameIndex = 0;
-			CurrentGroupIndex = (CurrentGroupIndex + 1) % TickGroupArray.Num();
-			CurrentDelta = 0.f;
-		}
-	}
+	void Invoke(UObject* Object, float DeltaTime) const;
+
+	/**
+	 * Invokes the function on all objects of the array at ClassIndex, parameter frame is allocated once for the whole batch.
+	 * Objects are looked up by index on each call, so scripts can register new objects and classes while the batch runs.
+	 */
+	void InvokeBatch(const TArray<FTickAggregatedBlueprintObjectArray>& ObjectArrays, const int32 ClassIndex, float DeltaTime) const;
 
 private:
-	uint64 FrameDelay;
-	uint64 CurrentFrameIndex;
-	int32 CurrentGroupIndex;
-	float CurrentDelta;
+
+	/** Runs the script of the function with given frame, which must be PropertiesSize big. */
+	void InvokeDirectly(UObject* Object, uint8* Frame, float DeltaTime) const;
+
+	UFunction* Function = nullptr;
+	int32 PropertiesSize = 0;
+	int32 MinAlignment = 0;
+	int32 DeltaSecondsOffset = INDEX_NONE;
+	bool bCanInvokeDirectly = false;
 };
 
 /**
@@ -351,15 +781,37 @@ struct FTickAggregatedBlueprintObjectArray
 
 	// FORCEINLINE is fine for this context.
 
-	FORCEINLINE const TArray<TPair<TWeakObjectPtr<UObject>, UFunction*>>& Get() const { return Array; }
-	FORCEINLINE int32 Add(UObject* Object, UFunction* Function) { return Array.Add({Object, Function}); }
-	FORCEINLINE int32 AddUnique(UObject* Object, UFunction* Function) { return Array.AddUnique({ Object, Function }); }
+	FORCEINLINE const TArray<FTickAggregatorBlueprintElement>& Get() const { return Array; }
+	FORCEINLINE int32 Add(UObject* Object, UFunction* Function) { BindInvoker(Function); return Array.Add({Object, Function}); }
+	FORCEINLINE int32 AddUnique(UObject* Object, UFunction* Function) { BindInvoker(Function); return Array.AddUnique({ Object, Function }); }
 	FORCEINLINE int32 Remove(UObject* Object, UFunction* Function) { return Array.Remove({ Object, Function }); }
 	FORCEINLINE int32 RemoveSwap(UObject* Object, UFunction* Function) { return Array.RemoveSwap({ Object, Function }, false); }
 	FORCEINLINE void RemoveAtSwap(const int32 Index) { return Array.RemoveAtSwap(Index); }
 
+	/** Removes every object in given set in a single pass, order of the rest is preserved. */
+	FORCEINLINE int32 RemoveAll(const TSet<UObject*>& Objects)
+	{
+		return Array.RemoveAll([&Objects](const FTickAggregatorBlueprintElement& Pair)
+		{
+			return Objects.Contains(Pair.Key);
+		});
+	}
+
+	/** Removes objects that are about to be collected or already destroyed. Only valid between reachability analysis and purge of a GC. */
+	FORCEINLINE int32 RemoveUnreachable()
+	{
+		return Array.RemoveAll([](const FTickAggregatorBlueprintElement& Pair)
+		{
+			return Pair.Key->IsUnreachable() || !IsValid(Pair.Key);
+		});
+	}
+
 	FORCEINLINE TSubclassOf<UObject> GetClassType() const { return ClassType; }
 	FORCEINLINE bool IsA(const TSubclassOf<UObject> Class) const { return Class == ClassType; }
+	FORCEINLINE bool IsEmpty() const { return Array.IsEmpty(); }
+
+	/** Invoker of the tick function of ClassType. Unordered array holds objects of different classes, so it must not be used there. */
+	FORCEINLINE const FTickAggregatorBlueprintInvoker& GetInvoker() const { return Invoker; }
 
 	friend bool operator==(const FTickAggregatedBlueprintObjectArray& Lhs, const FTickAggregatedBlueprintObjectArray& RHS)
 	{
@@ -379,12 +831,44 @@ private:
 	 * do that lookup during RegisterBlueprintFunction() and store the pointer to UFunction in this pair. So we get rid of the TMap lookup overhead
 	 * per function call in tick aggregator.
 	 * Also UFunction should be guaranteed to be valid until UObject pointer is valid, so we dont need multiple weak object pointers.
-	 * TWeakObjectPtr's ".Get()" function does an array lookup (which is only ~3 instructions in theory but still..) and we need to avoid it
+	 * Objects aren't weak pointers either, TWeakObjectPtr's ".Get()" function does an array lookup (which is only ~3 instructions in theory
+	 * but still..) and we need to avoid it. Instead, the aggregator sweeps unreachable objects after each GC.
 	 * (hey i made this plugin to microoptimize this process to moon so you dont have to!)
 	 */
-	TArray<TPair<TWeakObjectPtr<UObject>, UFunction*>> Array;
+	TArray<FTickAggregatorBlueprintElement> Array;
 	TSubclassOf<UObject> ClassType;
 
+	/** Resolved once when the first object of the class is added, all objects of the class share the same function. */
+	FTickAggregatorBlueprintInvoker Invoker;
+
+	FORCEINLINE void BindInvoker(UFunction* Function)
+	{
+		if (!Invoker.IsBound())
+		{
+			Invoker = FTickAggregatorBlueprintInvoker(Function);
+		}
+	}
+
+};
+
+/**
+ * Objects of a single blueprint class that are handed to their manager object in one BlueprintAggregatedBatchTick event per frame,
+ * instead of entering the BP VM once per object. Objects that are registered before their manager wait in the batch until it's registered.
+ */
+struct FTickAggregatedBlueprintBatch
+{
+	FTickAggregatedBlueprintBatch(TSubclassOf<UObject> InClassType) : Objects(InClassType) {}
+
+	/** Calls the batch event of the manager with all alive objects, if there is a manager. */
+	void Tick(float DeltaTime) const;
+
+	FORCEINLINE bool IsEmpty() const { return Objects.IsEmpty() && !Manager.IsValid(); }
+
+	/** Function of pairs is unused, manager's function is called for all of them. */
+	FTickAggregatedBlueprintObjectArray Objects;
+
+	TWeakObjectPtr<UObject> Manager;
+	UFunction* ManagerFunction = nullptr;
 };
 
 /**
@@ -399,12 +883,58 @@ struct FAggregatedTickFunctionCollection final
 	/**
 	 * Each tick function collections removes pending tick functions first, then ticks the objects.
 	 */
-	void Execute(float DeltaTime);
+	void Execute(float DeltaTime, const FTickAggregatorFrameContext& FrameContext);
+
+	/** True if there isn't any native function, blueprint object or batch to tick. Functions pending removal count until they're compacted by Execute(). */
+	FORCEINLINE bool IsEmpty() const
+	{
+		return ActiveNativeObjectArrays.IsEmpty() && RegisteredBlueprintObjectsArray.IsEmpty() && RegisteredBlueprintBatches.IsEmpty();
+	}
 
-	FTickAggregatorFunctionHandle AddNewNativeFunction(const UObject* Object, const FAggregatedTickDelegate& Function, const FName TickFunctionGroupName);
+	FORCEINLINE ETickAggregatorTickCategory::Type GetTickCategory() const { return AssociatedTickCategory; }
+
+	FTickAggregatorFunctionHandle AddNewNativeFunction(const UObject* Object, const FAggregatedTickDelegate& Function, const FTickFunctionGroupId TickFunctionGroupName, const FTickFunctionGroupSettings& Settings);
 	bool AddNewRemoveRequest(const FTickAggregatorFunctionHandle& InHandle);
 
+	/** See FTickAggregatorNativeObjectArray::Contains. */
+	bool ContainsNativeFunction(const FTickAggregatorFunctionHandle& InHandle) const;
+
+	template<typename GroupType>
+	FTickAggregatorFunctionHandle AddNewTypedNativeFunction(typename GroupType::ObjectType* Object, const FTickFunctionGroupId TickFunctionGroupName)
+	{
+		using namespace Intax::TA;
+
+		UClass* Class = Object->GetClass();
+		if (!ensure(Class))
+		{
+			return MakeInvalidFunctionHandle();
+		}
+
+		int32 ClassIndex = INDEX_NONE;
+		int32 GroupIndex = INDEX_NONE;
+		FTickAggregatorNativeObjectArray& ObjectArray = FindOrAddNativeObjectArray(Class, ClassIndex);
+		const FTickAggregatorSlotId Slot = ObjectArray.AddNewTypedTickFunction<GroupType>(TickFunctionGroupName, Object, GroupIndex);
+		if (Slot.IsValid())
+		{
+			return MakeNativeFunctionHandle(ObjectArray, ClassIndex, GroupIndex, true, Slot);
+		}
+
+		return MakeInvalidFunctionHandle();
+	}
+
 	bool AddNewBlueprintFunction(UObject* Object);
+	bool AddNewBlueprintRemoveRequest(UObject* Object);
+
+	/** Makes given manager receive the batch event of objects of ObjectClass. A class can only have one manager per collection. */
+	bool AddNewBlueprintBatchManager(UObject* Manager, UClass* ObjectClass);
+	bool RemoveBlueprintBatchManager(UObject* Manager, UClass* ObjectClass);
+
+	/** Adds given object to the batch of it's class, it's ticked by the manager of the batch. */
+	bool AddNewBlueprintBatchObject(UObject* Object);
+	bool AddNewBlueprintBatchRemoveRequest(UObject* Object);
+
+	/** See FAggregatedTickFunction::RemoveUnreachableObjects. */
+	void RemoveUnreachableObjects();
 
 #if !UE_BUILD_SHIPPING
 	void DumpTicks(const FString& CategoryName);
@@ -422,32 +952,95 @@ private:
 		static_assert(!std::is_pointer_v<T>);
 		static_assert(std::is_base_of_v<T, FTickAggregatorNativeObjectArray> || std::is_base_of_v<T, FTickAggregatedBlueprintObjectArray>);
 
-		T NewObjectArray(Class);
+		// native object arrays own their typed groups, so they can't be copied. emplace them in place instead.
 		if constexpr (std::is_base_of_v<T, FTickAggregatorNativeObjectArray>)
 		{
-			int32 Index = RegisteredNativeObjectsArray.Add(NewObjectArray);
-			return RegisteredNativeObjectsArray[Index];
+			return RegisteredNativeObjectsArray.Emplace_GetRef(Class);
 		}
 		else // if constexpr (std::is_base_of_v<T, FTickAggregatedBlueprintObjectArray>)
 		{
-			int32 Index = RegisteredBlueprintObjectsArray.Add(NewObjectArray);
-			return RegisteredBlueprintObjectsArray[Index];
+			return RegisteredBlueprintObjectsArray.Emplace_GetRef(Class);
+		}
+	}
+
+	/** Finds the native object array associated with given class, builds a new one if there isn't any. */
+	FTickAggregatorNativeObjectArray& FindOrAddNativeObjectArray(UClass* Class, int32& OutClassIndex);
+
+	FTickAggregatedBlueprintBatch& FindOrAddBlueprintBatch(UClass* Class);
+
+	/** Puts the class array back to tick loop if given function is the first one in it. */
+	FORCEINLINE void OnNativeFunctionAdded(const FTickAggregatorNativeObjectArray& ObjectArray, const int32 ClassIndex)
+	{
+		if (ObjectArray.Num() == 1)
+		{
+			ActiveNativeObjectArrays.Add(ClassIndex);
 		}
 	}
 
-	void TickObjects(float DeltaTime);
+	/**
+	 * Makes the handle of a function that was just added. If it's location doesn't fit into a handle, function is removed
+	 * again on next compaction since nobody could remove it otherwise, and an invalid handle is returned.
+	 */
+	FTickAggregatorFunctionHandle MakeNativeFunctionHandle(FTickAggregatorNativeObjectArray& ObjectArray, const int32 ClassIndex, const int32 GroupIndex, const bool bTypedFunction, const FTickAggregatorSlotId Slot);
+
+	/** Marks given function for removal and queues it's class array for compaction. */
+	bool MarkNativeFunctionPendingRemove(const int32 ClassIndex, const int32 GroupIndex, const bool bTypedFunction, const FTickAggregatorSlotId Slot);
+
+	void TickObjects(float DeltaTime, const FTickAggregatorFrameContext& FrameContext);
 	void RemoveAndDestroyRequiredObjects();
 
+	/** Erases BP arrays that have no objects left and rebuilds the class lookup. No handles point to BP arrays, so this is safe. */
+	void RemoveEmptyBlueprintObjectArrays();
+
+	/** Native object arrays are never removed, handles store their index. Empty ones only release their memory. */
 	TArray<FTickAggregatorNativeObjectArray> RegisteredNativeObjectsArray;
-	TArray<FTickAggregatorFunctionHandle> NativeFunctionsPendingRemove;
+
+	/** Indices of native object arrays that have any functions, tick loop only goes over these. Arrays that become empty are dropped in bulk after compaction. */
+	TArray<int32> ActiveNativeObjectArrays;
+
+	/** Indices of native object arrays that have functions marked for removal. */
+	TArray<int32> NativeObjectArraysPendingCompaction;
+
+	/** Internal index of the class (UObjectBase::GetUniqueID) -> index in RegisteredNativeObjectsArray. */
+	TMap<uint32, int32> NativeClassIndices;
 
 	TArray<FTickAggregatedBlueprintObjectArray> RegisteredBlueprintObjectsArray;
-	TArray<UObject*> BlueprintObjectsPendingRemove;
+	TSet<UObject*> BlueprintObjectsPendingRemove;
+
+	/** Internal index of the class -> index in RegisteredBlueprintObjectsArray. Rebuilt when empty BP arrays are erased. */
+	TMap<uint32, int32> BlueprintClassIndices;
+
+	/** There is only a batch per managed class, so these are looked up linearly. */
+	TArray<FTickAggregatedBlueprintBatch> RegisteredBlueprintBatches;
+	TSet<UObject*> BlueprintBatchObjectsPendingRemove;
+
+	/** Set when a batch might have become empty, empty batches are erased before next tick. */
+	bool bBlueprintBatchesDirty = false;
 
 	/** The tick category that this aggregated tick function is associated with. */
 	ETickAggregatorTickCategory::Type AssociatedTickCategory = ETickAggregatorTickCategory::TC_MAX;
 
 	ETickingGroup AssociatedTickingGroup = TG_MAX;
+
+#if TICK_AGGREGATOR_TRACE_ENABLED
+	/** Named on first traced tick, ticking group's enum name isn't safe to query while subsystem's CDO is constructed. */
+	FTickAggregatorTraceScopeName TraceName;
+#endif
+};
+
+struct FAggregatedTickFunction;
+
+/**
+ * Registration or removal request that is pushed from any thread, and applied on game thread at the start of the
+ * next world tick by UTickAggregatorWorldSubsystem. Tick functions might be disabled while they're empty, so they can't drain it themselves.
+ */
+struct FTickAggregatorPendingRequest
+{
+	/** Registers the function on game thread and returns it's handle. Unbound for removal requests. */
+	TUniqueFunction<FTickAggregatorFunctionHandle(FAggregatedTickFunction&)> Register;
+
+	/** Deferred handle that was given to the caller for registrations, or the handle to remove for removals. */
+	FTickAggregatorFunctionHandle Handle;
 };
 
 struct FAggregatedTickFunction : public FTickFunction
@@ -469,35 +1062,112 @@ struct FAggregatedTickFunction : public FTickFunction
 	NativeUnorderedTickFunctions(),
 	BlueprintUnorderedTickFunctions()
 	{
-		check(AssociatedTickGroup != TG_MAX);
+		check(InTickingGroup != TG_MAX);
 		AssociatedTickGroup   = InTickingGroup;
 		bCanEverTick          = true;
-		bStartWithTickEnabled = true;
+		bStartWithTickEnabled = false;
 		bRunOnAnyThread       = false;
+
+		// enabled when the first function is registered, see MarkCategoryOccupied().
+		SetTickFunctionEnable(false);
 	}
 
-	FTickAggregatorFunctionHandle RegisterNativeFunction(const UObject* Object, const FAggregatedTickDelegate& Function, ETickAggregatorTickCategory::Type Category, const FName TickFunctionGroupName);
+	FTickAggregatorFunctionHandle RegisterNativeFunction(const UObject* Object, const FAggregatedTickDelegate& Function, ETickAggregatorTickCategory::Type Category, const FTickFunctionGroupId TickFunctionGroupName, const FTickFunctionGroupSettings& Settings = FTickFunctionGroupSettings());
+
+	/**
+	 * Removes the function of given handle from it's category, including unordered ones. Deferred handles are resolved first,
+	 * if their registration is still queued it's cancelled instead. Game thread only.
+	 */
 	bool RemoveNativeFunction(const FTickAggregatorFunctionHandle& InHandle);
 
+	/**
+	 * Thread-safe. Queues given registration and returns a deferred handle that can be used right away, i.e. to remove the
+	 * function again. Registration is applied on game thread at the start of next world tick, unless it's removed before that.
+	 */
+	FTickAggregatorFunctionHandle EnqueueRegisterRequest(const ETickAggregatorTickCategory::Type Category, TUniqueFunction<FTickAggregatorFunctionHandle(FAggregatedTickFunction&)>&& Register);
+
+	/** Thread-safe. Queues removal of given handle, which can be a deferred one. */
+	void EnqueueRemoveRequest(const FTickAggregatorFunctionHandle& InHandle);
+
+	/** Thread-safe. Queues a request that doesn't hand out a handle, i.e. registration of an interface object. */
+	void EnqueueRequest(TUniqueFunction<void()>&& Request);
+
+	/** Applies all queued requests in one batch. Game thread only. */
+	void ProcessPendingRequests();
+
 	bool RegisterBlueprintFunction(UObject* Object, ETickAggregatorTickCategory::Type Category);
+	bool RemoveBlueprintFunction(UObject* Object, ETickAggregatorTickCategory::Type Category);
+
+	/** See UTickAggregatorWorldSubsystem::RegisterBlueprintBatchManager. Unordered category doesn't support batches. */
+	bool RegisterBlueprintBatchManager(UObject* Manager, UClass* ObjectClass, ETickAggregatorTickCategory::Type Category);
+	bool RemoveBlueprintBatchManager(UObject* Manager, UClass* ObjectClass, ETickAggregatorTickCategory::Type Category);
+	bool RegisterBlueprintBatchObject(UObject* Object, ETickAggregatorTickCategory::Type Category);
+	bool RemoveBlueprintBatchObject(UObject* Object, ETickAggregatorTickCategory::Type Category);
+
+	template<typename GroupType>
+	FTickAggregatorFunctionHandle RegisterTypedNativeFunction(typename GroupType::ObjectType* Object, ETickAggregatorTickCategory::Type Category, const FTickFunctionGroupId TickFunctionGroupName)
+	{
+		using namespace Intax::TA;
+
+		if (!Object)
+		{
+			return MakeInvalidFunctionHandle();
+		}
+
+		if (Category == ETickAggregatorTickCategory::TC_UNORDERED)
+		{
+			int32 GroupIndex = INDEX_NONE;
+			const FTickAggregatorSlotId Slot = NativeUnorderedTickFunctions.AddNewTypedTickFunction<GroupType>(DefaultTickFunctionGroup, Object, GroupIndex);
+			if (Slot.IsValid())
+			{
+				MarkCategoryOccupied(ETickAggregatorTickCategory::TC_UNORDERED);
+				return MakeUnorderedFunctionHandle(GroupIndex, true, Slot);
+			}
+
+			return MakeInvalidFunctionHandle();
+		}
+
+		FAggregatedTickFunctionCollection* Collection = GetCollectionByCategory(Category);
+		if (!ensure(Collection))
+		{
+			return MakeInvalidFunctionHandle();
+		}
+
+		const FTickAggregatorFunctionHandle Handle = Collection->AddNewTypedNativeFunction<GroupType>(Object, TickFunctionGroupName);
+		if (Handle.IsValid())
+		{
+			MarkCategoryOccupied(Category);
+		}
+
+		return Handle;
+	}
 
 	FTickAggregatorFunctionHandle RegisterUnorderedNativeFunction(const UObject* Object, FAggregatedTickDelegate Function, ETickAggregatorTickCategory::Type Category);
 	bool RemoveUnorderedNativeFunction(const FTickAggregatorFunctionHandle& FunctionHandle);
 
 	bool RegisterUnorderedBlueprintFunction(UObject* Object, ETickAggregatorTickCategory::Type Category);
+	bool RemoveUnorderedBlueprintFunction(UObject* Object);
 
-	// Legacy support
+	// ITickAggregatorInterface objects
 
-	bool Legacy_AddNewObject(UObject* Object);
-	bool Legacy_RemoveObject(UObject* Object);
+	/**
+	 * Registers given interface object to given category like any other object, AggregatedTick() is bound to a delegate in the class
+	 * sorted native storage and BlueprintAggregatedTick to the blueprint arrays, so interface objects don't have a tick path of their own.
+	 * Interface cast is resolved once here. TC_UNORDERED registers to unordered functions. Returned registration is needed to remove it.
+	 */
+	FTickAggregatorInterfaceRegistration RegisterInterfaceObject(UObject* Object, ETickAggregatorTickCategory::Type Category);
 
-	bool Legacy_AddNewUnorderedObject(UObject* Object);
-	bool Legacy_RemoveUnorderedObject(UObject* Object);
+	/** Object can be null if it's already collected, only the native function is removed then. */
+	void RemoveInterfaceObject(UObject* Object, const FTickAggregatorInterfaceRegistration& Registration);
 
-	bool Legacy_RemoveObjectOnNextTick(UObject* Object);
-	bool Legacy_RemoveUnorderedObjectOnNextTick(UObject* Object);
+	/** Removes given interface object and destroys it at the start of next tick, so it's safe to call from object's own tick. */
+	void DestroyInterfaceObjectOnNextTick(UObject* Object, const FTickAggregatorInterfaceRegistration& Registration);
 
-	void Legacy_Tick(float DeltaTime);
+	/**
+	 * Blueprint objects are stored as raw pointers, so objects that are about to be collected must be removed before they're purged.
+	 * Called by the subsystem right after reachability analysis of each GC. Game thread only.
+	 */
+	void RemoveUnreachableObjects();
 
 #if !UE_BUILD_SHIPPING
 	/** Editor only function that prints every registered tick with required information to output log. */
@@ -511,9 +1181,45 @@ protected:
 	virtual FName DiagnosticContext(bool bDetailed) override;
 	// End of FTickFunction interface
 
+	/** Executes given collection if it's category is occupied, clears the category once collection becomes empty. */
+	void ExecuteCollection(FAggregatedTickFunctionCollection& Collection, float DeltaTime);
+
+	FORCEINLINE static uint32 GetCategoryBit(ETickAggregatorTickCategory::Type Category) { return 1u << Category; }
+	FORCEINLINE bool IsCategoryOccupied(ETickAggregatorTickCategory::Type Category) const { return (OccupiedCategories & GetCategoryBit(Category)) != 0; }
+
+	/** Sets category's bit and enables this tick function if it's disabled. Called whenever something is registered. */
+	void MarkCategoryOccupied(ETickAggregatorTickCategory::Type Category);
+	void EnableTick();
+
 	void ExecuteUnorderedTickFunctions(float DeltaTime) const;
 	void RemovePendingUnorderedTickFunctions();
 
+	void DestroyPendingInterfaceObjects();
+
+	/** Returns the ordered collection associated with given category. Returns nullptr for TC_UNORDERED and TC_MAX. */
+	FAggregatedTickFunctionCollection* GetCollectionByCategory(ETickAggregatorTickCategory::Type Category);
+
+	/**
+	 * Returns the real handle of given deferred handle and forgets the ticket. Returns given handle as is if it isn't deferred.
+	 * If registration of the ticket is still queued, it's cancelled instead and an invalid handle is returned.
+	 */
+	FTickAggregatorFunctionHandle ConsumeDeferredHandle(const FTickAggregatorFunctionHandle& InHandle);
+
+	/** Same as FAggregatedTickFunctionCollection::MakeNativeFunctionHandle, for unordered functions. */
+	FTickAggregatorFunctionHandle MakeUnorderedFunctionHandle(const int32 GroupIndex, const bool bTypedFunction, const FTickAggregatorSlotId Slot);
+
+	/** True if the function of given real handle is still registered, including unordered ones. */
+	bool IsNativeFunctionRegistered(const FTickAggregatorFunctionHandle& InHandle);
+
+	/** Pushes given request to PendingRequests from any thread. */
+	void PushPendingRequest(FTickAggregatorPendingRequest&& Request);
+
+	/** Dequeues and applies requests until the queue is empty, see ProcessPendingRequests. */
+	void ApplyPendingRequests();
+
+	/** Forgets resolved deferred handles whose functions are gone, so functions that weren't removed by their deferred handle don't leave their ticket behind. */
+	void PruneDeferredHandles();
+
 private:
 
 	FAggregatedTickFunctionCollection Alpha;
@@ -526,40 +1232,48 @@ private:
 	FAggregatedTickFunctionCollection Hotel;
 	FAggregatedTickFunctionCollection India;
 
+	/**
+	 * Bit per ETickAggregatorTickCategory that has anything registered. Set on registration, cleared once the category is found
+	 * empty after it's removals are compacted. Tick function disables itself when no bit is left.
+	 */
+	uint32 OccupiedCategories = 0;
+
 	FTickAggregatorNativeObjectArray NativeUnorderedTickFunctions;
-	TArray<FTickAggregatorFunctionHandle> NativeUnorderedTickFunctionsPendingRemove;
 
 	FTickAggregatedBlueprintObjectArray BlueprintUnorderedTickFunctions;
-	TArray<UObject*> BlueprintUnorderedObjectsPendingRemove;
+	TSet<UObject*> BlueprintUnorderedObjectsPendingRemove;
 
-	ETickingGroup AssociatedTickGroup;
-
-	// Legacy support
+	/** Requests pushed from any thread, drained on game thread. */
+	TQueue<FTickAggregatorPendingRequest, EQueueMode::Mpsc> PendingRequests;
 
-	UPROPERTY(Transient)
-	TMap<TSoftClassPtr<UClass>, FTickAggregatorObjectArray> Legacy_NativeAggregatedObjectTickElements;
+	/** Count of PushPendingRequest() calls in progress, see ProcessPendingRequests. */
+	std::atomic<int32> NumRequestsBeingQueued { 0 };
 
-	UPROPERTY(Transient)
-	TMap<TSoftClassPtr<UClass>, FTickAggregatorObjectArray> Legacy_BlueprintAggregatedObjectTickElements;
+	/**
+	 * Ticket of deferred handles -> real handles. Entries are dropped when the function is removed by it's deferred handle,
+	 * or by PruneDeferredHandles() once the function is gone. Map is pruned whenever it doubles, so it stays within twice
+	 * the count of live functions that were registered from other threads.
+	 */
+	TMap<uint64, FTickAggregatorFunctionHandle> DeferredHandles;
+	int32 DeferredHandlesPruneThreshold = Intax::TA::MinDeferredHandlesPruneThreshold;
 
-	UPROPERTY(Transient)
-	TArray<TWeakObjectPtr<UObject>> Legacy_NativeUnorderedObjectTickElements;
+	/** Tickets that were removed while their registration was still queued, ProcessPendingRequests() skips them. */
+	TSet<uint64> CancelledTickets;
 
-	UPROPERTY(Transient)
-	TArray<TWeakObjectPtr<UObject>> Legacy_BlueprintUnorderedObjectTickElements;
+	std::atomic<uint64> NextTicket { 1 };
 
-	UPROPERTY(Transient)
-	TArray<UObject*> Legacy_NativeObjectsToRemove;
+	ETickingGroup AssociatedTickGroup;
 
-	UPROPERTY(Transient)
-	TArray<UObject*> Legacy_NativeObjectsToRemoveUnordered;
+	/** Shared by all groups of all collections. Budget and view locations are set by UTickAggregatorWorldSubsystem. */
+	FTickAggregatorFrameContext FrameContext;
 
-	UPROPERTY(Transient)
-	TArray<UObject*> Legacy_BlueprintObjectsToRemove;
+#if TICK_AGGREGATOR_TRACE_ENABLED
+	/** Scope of unordered functions, mutable since unordered functions are executed from a const function. */
+	mutable FTickAggregatorTraceScopeName UnorderedTraceName;
+#endif
 
-	UPROPERTY(Transient)
-	TArray<UObject*> Legacy_BlueprintObjectsToRemoveUnordered;
-	
+	/** Objects that are destroyed at the start of next tick, see DestroyInterfaceObjectOnNextTick(). */
+	TArray<TWeakObjectPtr<UObject>> InterfaceObjectsPendingDestroy;
 };
 // It is unsafe to copy FTickFunctions and any subclasses of FTickFunction should specify the type trait WithCopy = false
 template<>
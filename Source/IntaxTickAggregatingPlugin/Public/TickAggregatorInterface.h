@@ -51,6 +51,12 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, DisplayName="Aggregated Tick")
 	void BlueprintAggregatedTick(float DeltaTime);
 
+	/** Called once per frame on manager objects registered via UTickAggregatorWorldSubsystem::RegisterBlueprintBatchManager(), with all
+	 * registered objects of the managed class. Lets a manager Blueprint tick a whole swarm in a single VM entry instead of one per object. */
+
+	UFUNCTION(BlueprintImplementableEvent, DisplayName="Aggregated Batch Tick")
+	void BlueprintAggregatedBatchTick(const TArray<UObject*>& Objects, float DeltaTime);
+
 	/** Should actor automatically registered to tick aggregator on spawn or if it's placed to level? */
 	
 	UFUNCTION(BlueprintNativeEvent)
@@ -77,6 +83,13 @@ public:
 	ETickingGroup GetTickingGroup() const; //{ return TG_PostPhysics; }
 	virtual ETickingGroup GetTickingGroup_Implementation() const { return TG_PostPhysics; }
 
+	/** Provide which category of the ticking group owner object should tick at. Objects registered through this interface share the
+	 * class sorted storage of this category with natively registered functions. */
+	
+	UFUNCTION(BlueprintNativeEvent)
+	TEnumAsByte<ETickAggregatorTickCategory::Type> GetTickCategory() const;
+	virtual TEnumAsByte<ETickAggregatorTickCategory::Type> GetTickCategory_Implementation() const { return ETickAggregatorTickCategory::TC_ALPHA; }
+
 	/** This function lets you override given component's ticking group (if owner is an actor). Return TG_MAX to ignore. */
 	
 	UFUNCTION(BlueprintNativeEvent)
@@ -0,0 +1,82 @@
+﻿// Copyright INTAX Interactive, all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TickAggregatorTypes.h"
+#include "Engine/AssetUserData.h"
+#include "TickAggregatorLevelManifest.generated.h"
+
+class ULevel;
+class FObjectPreSaveContext;
+class FObjectPostSaveContext;
+
+/** A placed object with the ticking group and category it resolved to when the manifest was built. */
+USTRUCT()
+struct FTickAggregatorManifestObject
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UObject> Object;
+
+	UPROPERTY()
+	TEnumAsByte<ETickingGroup> TickingGroup = TG_MAX;
+
+	UPROPERTY()
+	TEnumAsByte<ETickAggregatorTickCategory::Type> Category = ETickAggregatorTickCategory::TC_MAX;
+};
+
+/** A placed actor that implements ITickAggregatorInterface. */
+USTRUCT()
+struct FTickAggregatorManifestActor
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FTickAggregatorManifestObject Actor;
+
+	/** Components that UTickAggregatorWorldSubsystem::RegisterActor() would register along with the actor. */
+	UPROPERTY()
+	TArray<FTickAggregatorManifestObject> Components;
+
+	/** ShouldAutomaticallyRegisterActor(), only these are registered when the world starts. Streamed levels register all of them. */
+	UPROPERTY()
+	bool bAutoRegister = false;
+
+	/** ShouldTickAsUnordered(). */
+	UPROPERTY()
+	bool bUnordered = false;
+};
+
+/**
+ * Placed actors of a level that are registered to tick aggregator, recorded when the level is cooked and stored
+ * on the level as asset user data. UTickAggregatorWorldSubsystem registers placed actors from it instead of iterating
+ * all actors of the level and querying their interfaces, levels without a manifest are still iterated.
+ *
+ * Interface functions are called on the editor instances while building it, so they shouldn't depend on runtime state.
+ */
+UCLASS()
+class INTAXTICKAGGREGATINGPLUGIN_API UTickAggregatorLevelManifest : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	TArray<FTickAggregatorManifestActor> Actors;
+
+	/** Returns the manifest of given level, nullptr if it doesn't have one or if running with uncooked data. */
+	static const UTickAggregatorLevelManifest* Get(const ULevel* Level);
+
+#if WITH_EDITOR
+	/** Rebuilds the manifest of given level, removes it if level doesn't have any interface actor. */
+	static void Build(ULevel* Level);
+
+	/** Bound by the module to build manifests of worlds before they're cooked. */
+	static void OnObjectPreSave(UObject* Object, FObjectPreSaveContext SaveContext);
+
+	/** Bound by the module to remove manifests from worlds again once they're cooked, so they never end up in source levels. */
+	static void OnObjectPostSave(UObject* Object, FObjectPostSaveContext SaveContext);
+#endif
+};
@@ -0,0 +1,213 @@
+﻿// Copyright INTAX Interactive, all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Identifies an element in a TTickAggregatorSlotMap. Slot's generation is bumped every time it's freed, so ids that
+ * outlived their element are rejected instead of removing whatever took their slot.
+ */
+struct FTickAggregatorSlotId
+{
+	FTickAggregatorSlotId() {}
+	FTickAggregatorSlotId(const int32 InIndex, const uint16 InGeneration) : Index(InIndex), Generation(InGeneration) {}
+
+	FORCEINLINE bool IsValid() const { return Index != INDEX_NONE; }
+
+	int32 Index = INDEX_NONE;
+	/** Wraps around, 16 bits are plenty to tell apart ids of a slot that is reused in a short period. */
+	uint16 Generation = 0;
+};
+
+/**
+ * Dense array of elements with stable, generation counted ids.
+ *
+ * Elements are always stored contiguously so we can iterate them as fast as a regular TArray in tick loops. Each element
+ * is located through an indirection slot, so elements can move around in the dense array without invalidating their ids.
+ *
+ * Removal is done in bulk: elements are marked in a bitmap as requests arrive, then the whole array is compacted in one pass.
+ * This keeps mass-despawn frames linear in count of elements instead of paying a removal per request.
+ */
+template<typename ElementType>
+struct TTickAggregatorSlotMap
+{
+	// FORCEINLINE is fine for this context.
+
+	FORCEINLINE const TArray<ElementType>& GetElements() const { return Elements; }
+	FORCEINLINE TArray<ElementType>& GetElements() { return Elements; }
+	FORCEINLINE int32 Num() const { return Elements.Num(); }
+	FORCEINLINE bool IsEmpty() const { return Elements.IsEmpty(); }
+
+	template<typename... ArgsType>
+	FTickAggregatorSlotId Emplace(ArgsType&&... Args)
+	{
+		const int32 DenseIndex = Elements.Emplace(Forward<ArgsType>(Args)...);
+
+		// reuse a freed slot if we have any, so slot array doesn't grow forever with add/remove churn.
+		const int32 SlotIndex = FreeSlots.Num() > 0 ? FreeSlots.Pop(false) : Slots.AddDefaulted();
+		FSlot& Slot = Slots[SlotIndex];
+		Slot.DenseIndex = DenseIndex;
+		DenseToSlot.Add(SlotIndex);
+
+		return FTickAggregatorSlotId(SlotIndex, Slot.Generation);
+	}
+
+	FORCEINLINE bool Contains(const FTickAggregatorSlotId Id) const
+	{
+		return Slots.IsValidIndex(Id.Index) && Slots[Id.Index].Generation == Id.Generation && Slots[Id.Index].DenseIndex != INDEX_NONE;
+	}
+
+	/** Returns dense index of the element, INDEX_NONE if given id is stale. */
+	FORCEINLINE int32 GetDenseIndex(const FTickAggregatorSlotId Id) const
+	{
+		return Contains(Id) ? Slots[Id.Index].DenseIndex : INDEX_NONE;
+	}
+
+	ElementType* Find(const FTickAggregatorSlotId Id)
+	{
+		const int32 DenseIndex = GetDenseIndex(Id);
+		return DenseIndex != INDEX_NONE ? &Elements[DenseIndex] : nullptr;
+	}
+
+	/**
+	 * Marks the element for removal. Storage isn't touched, so it's safe to call while elements are being iterated.
+	 * Marked elements are removed by the next CompactPendingRemove(). Returns false if id is stale or already marked.
+	 */
+	bool MarkPendingRemove(const FTickAggregatorSlotId Id)
+	{
+		const int32 DenseIndex = GetDenseIndex(Id);
+		if (DenseIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		// mask only grows when something is marked, elements added after the last compaction are unmarked by default.
+		if (PendingRemoveMask.Num() < Elements.Num())
+		{
+			PendingRemoveMask.Add(false, Elements.Num() - PendingRemoveMask.Num());
+		}
+
+		if (PendingRemoveMask[DenseIndex])
+		{
+			return false;
+		}
+
+		PendingRemoveMask[DenseIndex] = true;
+		++NumPendingRemove;
+		return true;
+	}
+
+	FORCEINLINE bool HasPendingRemove() const { return NumPendingRemove > 0; }
+
+	/** Swaps positions of two elements in the dense array. Ids of both elements stay valid, so this is safe to use for partitioning. */
+	void Swap(const int32 DenseIndexA, const int32 DenseIndexB)
+	{
+		if (DenseIndexA == DenseIndexB)
+		{
+			return;
+		}
+
+		Elements.Swap(DenseIndexA, DenseIndexB);
+		DenseToSlot.Swap(DenseIndexA, DenseIndexB);
+		Slots[DenseToSlot[DenseIndexA]].DenseIndex = DenseIndexA;
+		Slots[DenseToSlot[DenseIndexB]].DenseIndex = DenseIndexB;
+
+		// marks must follow their elements, otherwise compaction would remove the wrong ones.
+		if (NumPendingRemove > 0)
+		{
+			if (PendingRemoveMask.Num() < Elements.Num())
+			{
+				PendingRemoveMask.Add(false, Elements.Num() - PendingRemoveMask.Num());
+			}
+
+			const bool bMarkedA = PendingRemoveMask[DenseIndexA];
+			PendingRemoveMask[DenseIndexA] = PendingRemoveMask[DenseIndexB];
+			PendingRemoveMask[DenseIndexB] = bMarkedA;
+		}
+	}
+
+	/**
+	 * Removes every marked element in a single linear pass, surviving elements keep their relative order.
+	 * If InOutCursor is given, it's moved to the dense index of the first surviving element at or after it.
+	 * Returns count of removed elements.
+	 */
+	int32 CompactPendingRemove(int32* InOutCursor = nullptr)
+	{
+		if (NumPendingRemove == 0)
+		{
+			return 0;
+		}
+
+		const int32 Cursor = InOutCursor ? *InOutCursor : INDEX_NONE;
+		int32 WriteIndex = 0;
+		for (int32 ReadIndex = 0; ReadIndex < Elements.Num(); ++ReadIndex)
+		{
+			if (ReadIndex == Cursor)
+			{
+				*InOutCursor = WriteIndex;
+			}
+
+			const int32 SlotIndex = DenseToSlot[ReadIndex];
+			if (ReadIndex < PendingRemoveMask.Num() && PendingRemoveMask[ReadIndex])
+			{
+				FreeSlot(SlotIndex);
+				continue;
+			}
+
+			if (WriteIndex != ReadIndex)
+			{
+				Elements[WriteIndex] = MoveTemp(Elements[ReadIndex]);
+				DenseToSlot[WriteIndex] = SlotIndex;
+				Slots[SlotIndex].DenseIndex = WriteIndex;
+			}
+			++WriteIndex;
+		}
+
+		const int32 NumRemoved = Elements.Num() - WriteIndex;
+		Elements.SetNum(WriteIndex, false);
+		DenseToSlot.SetNum(WriteIndex, false);
+		PendingRemoveMask.Reset();
+		NumPendingRemove = 0;
+		return NumRemoved;
+	}
+
+	/** Frees the memory of elements. Slots are kept, so ids that are still around are rejected by generation check. */
+	void ReleaseUnusedMemory()
+	{
+		Elements.Shrink();
+		DenseToSlot.Shrink();
+		PendingRemoveMask.Empty();
+	}
+
+protected:
+
+	struct FSlot
+	{
+		int32 DenseIndex = INDEX_NONE;
+		uint16 Generation = 0;
+	};
+
+	void FreeSlot(const int32 SlotIndex)
+	{
+		FSlot& Slot = Slots[SlotIndex];
+		Slot.DenseIndex = INDEX_NONE;
+		Slot.Generation++;
+		FreeSlots.Add(SlotIndex);
+	}
+
+	/** Tightly packed elements, this is what we iterate in tick loops. */
+	TArray<ElementType> Elements;
+
+	/** Dense index -> slot index. Used to patch the slots of the elements that are moved on compaction. */
+	TArray<int32> DenseToSlot;
+
+	/** Slot index -> dense index and generation. */
+	TArray<FSlot> Slots;
+
+	TArray<int32> FreeSlots;
+
+	/** Dense index -> whether element is marked for removal. */
+	TBitArray<> PendingRemoveMask;
+	int32 NumPendingRemove = 0;
+};
@@ -1,3 +0,0 @@
-﻿
-#include "TickAggregatorTypes.h"
-
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "EngineMinimal.h"
+#include "TickAggregatorSlotMap.h"
 #include "TickAggregatorTypes.generated.h"
 
 class UTickAggregatorWorldSubsystem;
@@ -19,6 +20,12 @@ DECLARE_LOG_CATEGORY_CLASS(LogTickAggregator, Log, All);
 
 DECLARE_STATS_GROUP(TEXT("Tick Aggregator"), STATGROUP_TickAggregator, STATCAT_Advanced);
 
+/** Cycle stats and call counters per class and per group. Created at registration, so they only cost a scope in tick loop. */
+#define TICK_AGGREGATOR_DYNAMIC_STATS (STATS && TICK_AGGREGATOR_DO_CHECKS)
+
+/** Named CPU scopes per category, class and group on TickAggregatorChannel, visible in Unreal Insights. */
+#define TICK_AGGREGATOR_TRACE_ENABLED CPUPROFILERTRACE_ENABLED
+
 #define TA_REGISTER_TICK(Handle, Object, Func, TickingGroup, Category, FuncGroup) \
 	{ \
 		if (UTickAggregatorWorldSubsystem* TA = GetWorld() ? GetWorld()->GetSubsystem<UTickAggregatorWorldSubsystem>() : nullptr) \
@@ -33,31 +40,126 @@ DECLARE_STATS_GROUP(TEXT("Tick Aggregator"), STATGROUP_TickAggregator, STATCAT_A
 		} \
 	} \
 
-#define TA_REGISTER_TICK_TIMESLICED(Handle, Object, Func, TickingGroup, Category, FuncGroup, Interval) \
+/** Same as TA_REGISTER_TICK, but marks the function group as thread-safe so it can be ticked in parallel on worker threads.
+ * Only use this if given function doesn't touch anything other than it's owner object's own state. */
+#define TA_REGISTER_TICK_THREADSAFE(Handle, Object, Func, TickingGroup, Category, FuncGroup) \
 	{ \
 		if (UTickAggregatorWorldSubsystem* TA = GetWorld() ? GetWorld()->GetSubsystem<UTickAggregatorWorldSubsystem>() : nullptr) \
 		{ \
 			FAggregatedTickDelegate Delegate; \
 			Delegate.BindUObject(Object, &ThisClass::Func); \
-			Handle = TA->RegisterNativeObject(Object, Delegate, TickingGroup, ETickAggregatorTickCategory::Category, FuncGroup); \
+			FTickFunctionGroupSettings Settings; \
+			Settings.bThreadSafe = true; \
+			Handle = TA->RegisterNativeObject(Object, Delegate, TickingGroup, ETickAggregatorTickCategory::Category, FuncGroup, Settings); \
 		} \
 		else \
 		{ \
-			TA_LOG(Warning, "TA_REGISTER_TICK macro's context executed earlier than world subsystems are initialized."); \
+			TA_LOG(Warning, "TA_REGISTER_TICK_THREADSAFE macro's context executed earlier than world subsystems are initialized."); \
+		} \
+	} \
+
+/** Registers given member function to a typed group. Unlike TA_REGISTER_TICK, function is called directly through a raw object
+ * pointer instead of a delegate so compiler is able to inline it. Object MUST remove it's handle via TA_REMOVE_TICK before it's destroyed. */
+#define TA_REGISTER_TICK_TYPED(Handle, Object, Func, TickingGroup, Category, FuncGroup) \
+	{ \
+		if (UTickAggregatorWorldSubsystem* TA = GetWorld() ? GetWorld()->GetSubsystem<UTickAggregatorWorldSubsystem>() : nullptr) \
+		{ \
+			Handle = TA->RegisterTypedNativeObject<ThisClass, &ThisClass::Func>(Object, TickingGroup, ETickAggregatorTickCategory::Category, FuncGroup); \
+		} \
+		else \
+		{ \
+			TA_LOG(Warning, "TA_REGISTER_TICK_TYPED macro's context executed earlier than world subsystems are initialized."); \
 		} \
 	} \
 
-#define TA_REGISTER_TICK_ROUNDROBIN(Handle, Object, Func, TickingGroup, Category, FuncGroup, Interval) \
+/** Registers object to a batch group. Func must be a static function of ThisClass with "void(TArrayView<ThisClass* const>, float)" signature,
+ * it's called once per frame with all registered objects of the class. Object MUST remove it's handle via TA_REMOVE_TICK before it's destroyed. */
+#define TA_REGISTER_BATCH_TICK(Handle, Object, Func, TickingGroup, Category, FuncGroup) \
+	{ \
+		if (UTickAggregatorWorldSubsystem* TA = GetWorld() ? GetWorld()->GetSubsystem<UTickAggregatorWorldSubsystem>() : nullptr) \
+		{ \
+			Handle = TA->RegisterBatchNativeObject<ThisClass, &ThisClass::Func>(Object, TickingGroup, ETickAggregatorTickCategory::Category, FuncGroup); \
+		} \
+		else \
+		{ \
+			TA_LOG(Warning, "TA_REGISTER_BATCH_TICK macro's context executed earlier than world subsystems are initialized."); \
+		} \
+	} \
+
+/** Registers given function to a time-sliced group. Each frame, functions of the group are ticked until BudgetMicroseconds is consumed
+ * and next frame continues from where it stopped. Each function receives the time passed since it's own last tick as DeltaTime. */
+#define TA_REGISTER_TICK_TIMESLICED(Handle, Object, Func, TickingGroup, Category, FuncGroup, BudgetMicroseconds) \
 	{ \
 		if (UTickAggregatorWorldSubsystem* TA = GetWorld() ? GetWorld()->GetSubsystem<UTickAggregatorWorldSubsystem>() : nullptr) \
 		{ \
 			FAggregatedTickDelegate Delegate; \
 			Delegate.BindUObject(Object, &ThisClass::Func); \
-			Handle = TA->RegisterNativeObject(Object, Delegate, TickingGroup, ETickAggregatorTickCategory::Category, FuncGroup); \
+			FTickFunctionGroupSettings Settings; \
+			Settings.Mode = ETickFunctionGroupMode::TimeSliced; \
+			Settings.TimeSliceBudgetMicroseconds = BudgetMicroseconds; \
+			Handle = TA->RegisterNativeObject(Object, Delegate, TickingGroup, ETickAggregatorTickCategory::Category, FuncGroup, Settings); \
 		} \
 		else \
 		{ \
-			TA_LOG(Warning, "TA_REGISTER_TICK macro's context executed earlier than world subsystems are initialized."); \
+			TA_LOG(Warning, "TA_REGISTER_TICK_TIMESLICED macro's context executed earlier than world subsystems are initialized."); \
+		} \
+	} \
+
+/** Registers given function to a round-robin group. Functions of the group are spread evenly over FrameCount frames, so each
+ * function ticks once every FrameCount frames and receives the time passed since it's own last tick as DeltaTime. */
+#define TA_REGISTER_TICK_ROUNDROBIN(Handle, Object, Func, TickingGroup, Category, FuncGroup, FrameCount) \
+	{ \
+		if (UTickAggregatorWorldSubsystem* TA = GetWorld() ? GetWorld()->GetSubsystem<UTickAggregatorWorldSubsystem>() : nullptr) \
+		{ \
+			FAggregatedTickDelegate Delegate; \
+			Delegate.BindUObject(Object, &ThisClass::Func); \
+			FTickFunctionGroupSettings Settings; \
+			Settings.Mode = ETickFunctionGroupMode::RoundRobin; \
+			Settings.RoundRobinFrameCount = FrameCount; \
+			Handle = TA->RegisterNativeObject(Object, Delegate, TickingGroup, ETickAggregatorTickCategory::Category, FuncGroup, Settings); \
+		} \
+		else \
+		{ \
+			TA_LOG(Warning, "TA_REGISTER_TICK_ROUNDROBIN macro's context executed earlier than world subsystems are initialized."); \
+		} \
+	} \
+
+/** Registers given function to an interval group. Each function ticks once every TickInterval seconds, but functions are staggered so
+ * only the share of the group that is due ticks each frame instead of all functions at once. Each function receives the time
+ * passed since it's own last tick as DeltaTime. */
+#define TA_REGISTER_TICK_INTERVAL(Handle, Object, Func, TickingGroup, Category, FuncGroup, TickInterval) \
+	{ \
+		if (UTickAggregatorWorldSubsystem* TA = GetWorld() ? GetWorld()->GetSubsystem<UTickAggregatorWorldSubsystem>() : nullptr) \
+		{ \
+			FAggregatedTickDelegate Delegate; \
+			Delegate.BindUObject(Object, &ThisClass::Func); \
+			FTickFunctionGroupSettings Settings; \
+			Settings.Mode = ETickFunctionGroupMode::Interval; \
+			Settings.IntervalSeconds = TickInterval; \
+			Handle = TA->RegisterNativeObject(Object, Delegate, TickingGroup, ETickAggregatorTickCategory::Category, FuncGroup, Settings); \
+		} \
+		else \
+		{ \
+			TA_LOG(Warning, "TA_REGISTER_TICK_INTERVAL macro's context executed earlier than world subsystems are initialized."); \
+		} \
+	} \
+
+/** Registers given function to a distance LOD group. Functions are moved between full, half, quarter rate and dormant buckets
+ * depending on the distance of Object to the nearest local player's view, see FTickFunctionGroupSettings::bUseDistanceLOD.
+ * Object must be an actor or an actor component. */
+#define TA_REGISTER_TICK_LOD(Handle, Object, Func, TickingGroup, Category, FuncGroup) \
+	{ \
+		if (UTickAggregatorWorldSubsystem* TA = GetWorld() ? GetWorld()->GetSubsystem<UTickAggregatorWorldSubsystem>() : nullptr) \
+		{ \
+			FAggregatedTickDelegate Delegate; \
+			Delegate.BindUObject(Object, &ThisClass::Func); \
+			FTickFunctionGroupSettings Settings; \
+			Settings.bUseDistanceLOD = true; \
+			Handle = TA->RegisterNativeObject(Object, Delegate, TickingGroup, ETickAggregatorTickCategory::Category, FuncGroup, Settings); \
+		} \
+		else \
+		{ \
+			TA_LOG(Warning, "TA_REGISTER_TICK_LOD macro's context executed earlier than world subsystems are initialized."); \
 		} \
 	} \
 
@@ -145,48 +247,281 @@ namespace ETickAggregatorTickCategory
 	 */
 }
 
+/**
+ * Integer id of a tick function group. Groups are found by their id on registration, so adding a function to an existing
+ * group is a single hash lookup no matter how many groups there are.
+ *
+ * Ids of group names that are known at compile time are hashed by the compiler:
+ *     static constexpr FTickFunctionGroupId MovementGroup(TEXT("Movement"));
+ *
+ * Ids made from an FName are hashed once per name and cached. Both ways produce the same id for the same name, names are
+ * case insensitive just like FNames. Narrow literals ("Movement") go through an FName, same as when groups were named by
+ * FNames. Other TCHAR strings need to be wrapped in an FName.
+ *
+ * Two different names that end up with the same id would share their group. Builds with TICK_AGGREGATOR_DO_CHECKS fail
+ * as soon as both names are seen, ids of literals are checked whenever a function is registered with them.
+ */
+struct FTickFunctionGroupId
+{
+	constexpr FTickFunctionGroupId() {}
+
+	/**
+	 * For string literals only, given array is referenced by the id and read again when group is created. Strings in local
+	 * buffers or any other storage that doesn't outlive the id must be wrapped in an FName.
+	 */
+	template<int32 N>
+	constexpr FTickFunctionGroupId(const TCHAR (&InName)[N]) : Value(Hash(InName, Length(InName, N - 1))), Literal(InName) {}
+
+	INTAXTICKAGGREGATINGPLUGIN_API FTickFunctionGroupId(const FName InName);
+
+	FTickFunctionGroupId(const ANSICHAR* InName) : FTickFunctionGroupId(FName(InName)) {}
+
+	FORCEINLINE constexpr bool IsValid() const { return Value != 0; }
+	FORCEINLINE constexpr uint32 GetValue() const { return Value; }
+
+	/** Name of the group, only used when group is created and for debugging. */
+	INTAXTICKAGGREGATINGPLUGIN_API FName ToName() const;
+
+#if TICK_AGGREGATOR_DO_CHECKS
+	/** Fails if a different name is known with the same id. Ids made from FNames are already checked when they're made. */
+	INTAXTICKAGGREGATINGPLUGIN_API void CheckCollision() const;
+#endif
+
+	FORCEINLINE constexpr bool operator==(const FTickFunctionGroupId& Other) const { return Value == Other.Value; }
+	FORCEINLINE constexpr bool operator!=(const FTickFunctionGroupId& Other) const { return Value != Other.Value; }
+
+	friend FORCEINLINE uint32 GetTypeHash(const FTickFunctionGroupId& Id) { return Id.Value; }
+
+	/** 32-bit FNV-1a of lower case characters of given string. Empty string is reserved for invalid id. */
+	static constexpr uint32 Hash(const TCHAR* InName, const int32 InLength)
+	{
+		if (InLength <= 0)
+		{
+			return 0;
+		}
+
+		uint32 Result = 2166136261u;
+		for (int32 Index = 0; Index < InLength; ++Index)
+		{
+			const TCHAR Char = InName[Index];
+			const TCHAR LowerChar = (Char >= TEXT('A') && Char <= TEXT('Z')) ? static_cast<TCHAR>(Char + (TEXT('a') - TEXT('A'))) : Char;
+			Result = (Result ^ static_cast<uint32>(LowerChar)) * 16777619u;
+		}
+
+		return Result;
+	}
+
+private:
+	/** Length of given string up to it's first null terminator, so nothing past it ends up in the id. */
+	static constexpr int32 Length(const TCHAR* InName, const int32 InMaxLength)
+	{
+		int32 Result = 0;
+		while (Result < InMaxLength && InName[Result] != TEXT('\0'))
+		{
+			++Result;
+		}
+
+		return Result;
+	}
+
+	uint32 Value = 0;
+
+	/** Set only for ids that are made from string literals. */
+	const TCHAR* Literal = nullptr;
+};
+
+/** Determines how functions of a tick function group are distributed over frames. */
+enum class ETickFunctionGroupMode : uint8
+{
+	/** Every function is ticked every frame. */
+	EveryFrame,
+
+	/** Functions are ticked until FTickFunctionGroupSettings::TimeSliceBudgetMicroseconds is consumed, next frame continues
+	 * from where it stopped. Each function is ticked at most once per frame. */
+	TimeSliced,
+
+	/** Functions are spread evenly over FTickFunctionGroupSettings::RoundRobinFrameCount frames. Slice of each frame is
+	 * calculated from current count of functions, so it stays balanced as functions are added and removed. */
+	RoundRobin,
+
+	/** Each function ticks once every FTickFunctionGroupSettings::IntervalSeconds. Functions are staggered, so each frame
+	 * only DeltaTime / IntervalSeconds of the group ticks instead of the whole group at once. */
+	Interval,
+};
+
+/** Tick rate buckets of distance based tick LOD. Functions of a LOD group are kept partitioned by these in their group. */
+enum class ETickAggregatorLOD : uint8
+{
+	/** Ticks every frame. */
+	Full,
+	/** Ticks every 2nd frame. */
+	Half,
+	/** Ticks every 4th frame. */
+	Quarter,
+	/** Doesn't tick until it gets closer to a view. Receives the whole dormant time as DeltaTime on it's next tick. */
+	Dormant,
+
+	MAX
+};
+
+/** Determines whether a tick function group can be deferred when world's tick aggregator frame budget is exceeded. */
+enum class ETickFunctionGroupPriority : uint8
+{
+	/** Always ticks. */
+	Critical,
+
+	/** Ticks unless the frame is already over Intax::TA::NormalPriorityBudgetScale times the budget, so only severe hitches defer it. */
+	Normal,
+
+	/** Ticks only if there is budget left, otherwise it's deferred to the next frame with it's accumulated delta. */
+	Deferrable,
+};
+
+/**
+ * Settings of a tick function group. First registration creates the group with it's settings, later registrations
+ * to the same group can only make them more conservative (i.e. a single non thread-safe function makes whole group serial).
+ */
+struct FTickFunctionGroupSettings
+{
+	FTickFunctionGroupSettings() {}
+
+	/** Functions in this group don't touch any shared state, so group can be split into batches and executed on worker threads.
+	 * We always wait for all batches to finish before the next group starts ticking. */
+	bool bThreadSafe = false;
+
+	/** Mode can't be changed after group is created, functions registered with a different mode join the existing group's mode. */
+	ETickFunctionGroupMode Mode = ETickFunctionGroupMode::EveryFrame;
+
+	/** Max time functions of a TimeSliced group can take per frame. At least one function is ticked per frame, so a group always progresses. */
+	float TimeSliceBudgetMicroseconds = 0.f;
+
+	/** Count of frames functions of a RoundRobin group are spread over. Each function ticks once in this many frames. */
+	int32 RoundRobinFrameCount = 1;
+
+	/** Time between two ticks of each function of an Interval group. */
+	float IntervalSeconds = 0.f;
+
+	/**
+	 * Moves functions between full-rate, half-rate, quarter-rate and dormant buckets depending on the distance of their object
+	 * to the nearest local player's view. Only supported by EveryFrame groups, objects must be actors or actor components.
+	 */
+	bool bUseDistanceLOD = false;
+
+	/** Max distance of each LOD bucket. Functions that are further than QuarterRateDistance are dormant. */
+	float FullRateDistance = 2000.f;
+	float HalfRateDistance = 5000.f;
+	float QuarterRateDistance = 10000.f;
+
+	/** Count of functions that LOD is re-evaluated for per frame, evaluation continues from where it stopped on next frame. */
+	int32 LODEvaluationsPerFrame = 64;
+
+	/** See UTickAggregatorWorldSubsystem::FrameBudgetMilliseconds. Group's time is counted against the budget regardless of it's priority. */
+	ETickFunctionGroupPriority Priority = ETickFunctionGroupPriority::Normal;
+};
+
 /*
  * Function handles are similar to timer handles, they hold the information of where is the tick function
  * being stored in the FTickAggregatorNativeObjectArray. User should save this in the owner object of the given
  * tick function to manage the state of the registered tick function via tick aggregator subsystem.
+ *
+ * Handle directly locates the function: ClassIndex points to the class array in the collection, GroupIndex to the group
+ * in that class array and Index/Generation to the slot in that group. A handle that outlived it's function is rejected
+ * by generation check.
+ *
+ * Everything is packed into a single uint64, so handles are cheap to copy and compare:
+ *
+ *   | Generation 16 | Index 20 | GroupIndex 7 | Typed 1 | ClassIndex 12 | TickCategory 4 | TickingGroup 4 |
+ *
+ * Registrations that are queued from other threads get a deferred handle instead. Deferred handles have all class and group
+ * bits set and carry a ticket in Index and Generation bits, ticket is mapped to the real handle when the queue is drained.
  */
 struct FTickAggregatorFunctionHandle
 {
+	static constexpr uint32 TickingGroupBits = 4;
+	static constexpr uint32 TickCategoryBits = 4;
+	static constexpr uint32 ClassIndexBits = 12;
+	static constexpr uint32 TypedBits = 1;
+	static constexpr uint32 GroupIndexBits = 7;
+	static constexpr uint32 IndexBits = 20;
+	static constexpr uint32 GenerationBits = 16;
+
+	static constexpr uint32 TickingGroupShift = 0;
+	static constexpr uint32 TickCategoryShift = TickingGroupShift + TickingGroupBits;
+	static constexpr uint32 ClassIndexShift = TickCategoryShift + TickCategoryBits;
+	static constexpr uint32 TypedShift = ClassIndexShift + ClassIndexBits;
+	static constexpr uint32 GroupIndexShift = TypedShift + TypedBits;
+	static constexpr uint32 IndexShift = GroupIndexShift + GroupIndexBits;
+	static constexpr uint32 GenerationShift = IndexShift + IndexBits;
+
+	static_assert(GenerationShift + GenerationBits == 64, "FTickAggregatorFunctionHandle fields must fill exactly 64 bits.");
+	static_assert(ETickAggregatorTickCategory::TC_MAX < (1 << TickCategoryBits), "Tick categories don't fit into FTickAggregatorFunctionHandle.");
+	static_assert(TG_MAX < (1 << TickingGroupBits), "Ticking groups don't fit into FTickAggregatorFunctionHandle.");
+
+	/** Max count of class arrays per collection, groups per class and functions per group a handle can address. Last class and group index is reserved for deferred handles. */
+	static constexpr int32 MaxClassIndex = (1 << ClassIndexBits) - 2;
+	static constexpr int32 MaxGroupIndex = (1 << GroupIndexBits) - 2;
+	static constexpr int32 MaxIndex = (1 << IndexBits) - 1;
+
+	static constexpr uint64 TicketMask = (1ull << (IndexBits + GenerationBits)) - 1;
+
+	/** All bits set is never a valid handle since ticking group bits would be out of range. */
+	static constexpr uint64 InvalidValue = MAX_uint64;
+
 	FTickAggregatorFunctionHandle() {}
-	FTickAggregatorFunctionHandle(const int32 InIndex, const ETickAggregatorTickCategory::Type InTickCategory, TEnumAsByte<ETickingGroup> InTickingGroup, TSubclassOf<UObject> InClassType, const class FName InIdentity)
-		: ClassType(InClassType), Definition(InIdentity), Index(InIndex), TickCategory(InTickCategory), TickingGroup(InTickingGroup)
+	FTickAggregatorFunctionHandle(const int32 InIndex, const uint16 InGeneration, const int32 InClassIndex, const int32 InGroupIndex, const bool bInTypedFunction,
+	                              const ETickAggregatorTickCategory::Type InTickCategory, const ETickingGroup InTickingGroup)
+		: Value(Pack(InTickingGroup, TickingGroupShift)
+			| Pack(InTickCategory, TickCategoryShift)
+			| Pack(InClassIndex, ClassIndexShift)
+			| Pack(bInTypedFunction ? 1 : 0, TypedShift)
+			| Pack(InGroupIndex, GroupIndexShift)
+			| Pack(InIndex, IndexShift)
+			| Pack(InGeneration, GenerationShift))
 	{
 	}
 
-	FORCEINLINE bool IsValid() const { return Index != INDEX_NONE && TickCategory != TC_MAX && TickingGroup != TG_MAX && ClassType != nullptr; }
+	/** Makes a deferred handle for given ticket, see FAggregatedTickFunction::EnqueueRequest. */
+	static FTickAggregatorFunctionHandle MakeDeferred(const uint64 InTicket, const ETickAggregatorTickCategory::Type InTickCategory, const ETickingGroup InTickingGroup)
+	{
+		FTickAggregatorFunctionHandle Handle(0, 0, MaxClassIndex + 1, MaxGroupIndex + 1, false, InTickCategory, InTickingGroup);
+		Handle.Value |= Pack(InTicket & TicketMask, IndexShift);
+		return Handle;
+	}
 
-	FORCEINLINE FAggregatedTickDelegate GetTickFunction() const { return TickFunction; }
-	FORCEINLINE FName GetIdentity() const { return Definition; }
-	FORCEINLINE int32 GetIndex() const { return Index; }
-	FORCEINLINE ETickAggregatorTickCategory::Type GetTickCategory() const { return TickCategory; }
-	FORCEINLINE TEnumAsByte<ETickingGroup> GetTickingGroup() const { return TickingGroup; }
-	FORCEINLINE TSubclassOf<UObject> GetClassType() const { return ClassType; }
+	FORCEINLINE bool IsValid() const { return Value != InvalidValue; }
+	FORCEINLINE bool IsDeferred() const { return IsValid() && GetClassIndex() == MaxClassIndex + 1 && GetGroupIndex() == MaxGroupIndex + 1; }
+	FORCEINLINE uint64 GetTicket() const { return (Value >> IndexShift) & TicketMask; }
 
-	bool operator==(const FTickAggregatorFunctionHandle& Other) const
+	FORCEINLINE int32 GetIndex() const { return Unpack(IndexShift, IndexBits); }
+	FORCEINLINE uint16 GetGeneration() const { return static_cast<uint16>(Unpack(GenerationShift, GenerationBits)); }
+	FORCEINLINE int32 GetClassIndex() const { return Unpack(ClassIndexShift, ClassIndexBits); }
+	FORCEINLINE int32 GetGroupIndex() const { return Unpack(GroupIndexShift, GroupIndexBits); }
+	FORCEINLINE ETickAggregatorTickCategory::Type GetTickCategory() const
 	{
-		return Other.Index == Index
-			&& Other.TickingGroup == TickingGroup
-			&& Other.TickCategory == TickCategory
-			&& Other.ClassType == ClassType
-			&& Other.Definition == Definition
-			&& Other.TickFunction.GetHandle() == TickFunction.GetHandle();
+		return IsValid() ? static_cast<ETickAggregatorTickCategory::Type>(Unpack(TickCategoryShift, TickCategoryBits)) : ETickAggregatorTickCategory::TC_MAX;
 	}
+	FORCEINLINE ETickingGroup GetTickingGroup() const
+	{
+		return IsValid() ? static_cast<ETickingGroup>(Unpack(TickingGroupShift, TickingGroupBits)) : TG_MAX;
+	}
+	FORCEINLINE bool IsTypedFunction() const { return Unpack(TypedShift, TypedBits) != 0; }
+	FORCEINLINE FTickAggregatorSlotId GetSlot() const { return FTickAggregatorSlotId(GetIndex(), GetGeneration()); }
+
+	FORCEINLINE bool operator==(const FTickAggregatorFunctionHandle& Other) const { return Value == Other.Value; }
+	FORCEINLINE bool operator!=(const FTickAggregatorFunctionHandle& Other) const { return Value != Other.Value; }
+
+	friend FORCEINLINE uint32 GetTypeHash(const FTickAggregatorFunctionHandle& Handle) { return GetTypeHash(Handle.Value); }
 
 private:
 
-	FAggregatedTickDelegate TickFunction;
-	TSubclassOf<UObject> ClassType = nullptr;
-	FName Definition = NAME_None;
-	int32 Index = INDEX_NONE;
-	ETickAggregatorTickCategory::Type TickCategory = ETickAggregatorTickCategory::TC_MAX;
-	TEnumAsByte<ETickingGroup> TickingGroup = TG_MAX;
+	static FORCEINLINE uint64 Pack(const uint64 Field, const uint32 Shift) { return Field << Shift; }
+	FORCEINLINE int32 Unpack(const uint32 Shift, const uint32 Bits) const { return static_cast<int32>((Value >> Shift) & ((1ull << Bits) - 1)); }
+
+	uint64 Value = InvalidValue;
 };
 
+static_assert(sizeof(FTickAggregatorFunctionHandle) == sizeof(uint64), "FTickAggregatorFunctionHandle must stay 8 bytes.");
+
 namespace Intax
 {
 	namespace TA // Tick Aggregator
@@ -206,10 +541,27 @@ namespace Intax
 		static FTickAggregatorEvent OnTickAggregatorDeinitialized;
 
 		static const char* BlueprintTickFunctionName = "BlueprintAggregatedTick";
+		static const char* BlueprintBatchTickFunctionName = "BlueprintAggregatedBatchTick";
 
 		static const char* DefaultTickFunctionCategory = "Default";
 		static const char* InvalidTickFunctionCategory = "NONE";
 
+		/** Group that unordered native functions are registered to. */
+		static constexpr FTickFunctionGroupId DefaultTickFunctionGroup = FTickFunctionGroupId(TEXT("Default"));
+
+		/** Count of tick functions each worker thread executes at once for thread-safe groups. Groups smaller than this are
+		 * always ticked on game thread since waking up workers would cost more than the work itself. */
+		static constexpr int32 ParallelTickBatchSize = 512;
+
+		/** Normal priority groups are only deferred once the frame exceeds budget by this scale, see ETickFunctionGroupPriority. */
+		static constexpr double NormalPriorityBudgetScale = 2.0;
+
+		/** Deferred groups are forced to tick after this many frames, so an overloaded frame budget can't starve them forever. */
+		static constexpr int32 MaxDeferredFrames = 8;
+
+		/** Resolved deferred handles are checked for functions that are gone once there are this many, see FAggregatedTickFunction::DeferredHandles. */
+		static constexpr int32 MinDeferredHandlesPruneThreshold = 64;
+
 		/* Blueprint VM takes a "void*" (anonymous data) to invoke Blueprint functions with parameters. Since we know our
 		 * Blueprint tick function only takes a float variable as DeltaSeconds, we just need to have a struct that ProcessEvent()
 		 * function can access a float variable inside of it.
@@ -221,6 +573,13 @@ namespace Intax
 			float DeltaTime;
 		};
 
+		/* Same as TickAggregatorDeltaSecondsParam, for BlueprintAggregatedBatchTick(const TArray<UObject*>&, float). */
+		struct TickAggregatorBatchParams
+		{
+			TArray<UObject*> Objects;
+			float DeltaTime = 0.f;
+		};
+
 		static bool IsBlueprintObject(const UObject* Object)
 		{
 			if (!Object)
@@ -281,14 +640,22 @@ namespace Intax
 			return LastSuperClass != nullptr;
 		}
 
-		static FTickAggregatorFunctionHandle MakeFunctionHandle(const int32 InIndex, ETickAggregatorTickCategory::Type InTickCategory, ETickingGroup InTickingGroup, TSubclassOf<UObject> InClassType, const FName InIdentity)
+		static FTickAggregatorFunctionHandle MakeFunctionHandle(const FTickAggregatorSlotId InSlot, const int32 InClassIndex, const int32 InGroupIndex, const bool bInTypedFunction,
+		                                                        ETickAggregatorTickCategory::Type InTickCategory, ETickingGroup InTickingGroup)
 		{
-			return FTickAggregatorFunctionHandle(InIndex, InTickCategory, InTickingGroup, InClassType, InIdentity);
+			using FHandle = FTickAggregatorFunctionHandle;
+			if (!ensureMsgf(InSlot.Index <= FHandle::MaxIndex && InClassIndex <= FHandle::MaxClassIndex && InGroupIndex <= FHandle::MaxGroupIndex,
+				TEXT("Tick function location (Class: %d, Group: %d, Slot: %d) doesn't fit into a function handle!"), InClassIndex, InGroupIndex, InSlot.Index))
+			{
+				return FTickAggregatorFunctionHandle();
+			}
+
+			return FTickAggregatorFunctionHandle(InSlot.Index, InSlot.Generation, InClassIndex, InGroupIndex, bInTypedFunction, InTickCategory, InTickingGroup);
 		}
 
 		static FTickAggregatorFunctionHandle MakeInvalidFunctionHandle()
 		{
-			return FTickAggregatorFunctionHandle(-1, ETickAggregatorTickCategory::TC_MAX, TG_MAX, nullptr, NAME_None);
+			return FTickAggregatorFunctionHandle();
 		}
 	}
 }
@@ -4,9 +4,47 @@
 
 #include "CoreMinimal.h"
 #include "AggregatedTickFunction.h"
+#include "UObject/ObjectKey.h"
 #include "TickAggregatorWorldSubsystem.generated.h"
 
 class ITickAggregatorInterface;
+struct FTickAggregatorManifestActor;
+
+/**
+ * Registration record of an object registered through ITickAggregatorInterface. Filled once at registration, so removing an object
+ * doesn't query the interface again and always removes it from where it was registered to.
+ */
+struct FTickAggregatorObjectRegistration
+{
+	/** Tick function that object is registered to, TG_MAX while registration is pending for next frame. */
+	ETickingGroup TickingGroup = TG_MAX;
+
+	FTickAggregatorInterfaceRegistration Interface;
+
+	/** Components that were registered along with the actor by RegisterActor(), they're removed with it. */
+	TArray<FObjectKey, TInlineAllocator<4>> OwnedComponents;
+
+	/** Level that object is in, if any. */
+	FObjectKey Level;
+};
+
+/** Actors of a streamed in level that are registered over multiple frames. */
+struct FTickAggregatorLevelRegistrationJob
+{
+	TWeakObjectPtr<ULevel> Level;
+	int32 NextActorIndex = 0;
+};
+
+/** Registration requested by RegisterObject() or RegisterUnorderedObject(), applied at the start of next frame. */
+struct FTickAggregatorPendingObjectRegistration
+{
+	TWeakObjectPtr<UObject> Object;
+	bool bUnordered = false;
+
+	/** Known ahead if object is registered from a level manifest, resolved through the interface on flush otherwise. */
+	ETickingGroup TickingGroup = TG_MAX;
+	ETickAggregatorTickCategory::Type Category = ETickAggregatorTickCategory::TC_MAX;
+};
 
 /**
  * Tick aggregator subsystem that manages the FTickFunction's and handles registration/removal of objects to them.
@@ -28,15 +66,60 @@ public:
 	
 	bool HasAnyDerivedClasses() const;
 	
-	FTickAggregatorFunctionHandle RegisterNativeObject(const UObject* Object, const FAggregatedTickDelegate& Function, const ETickingGroup TickingGroup, ETickAggregatorTickCategory::Type Category, const FName TickFunctionGroup);
+	/**
+	 * Register a native tick function to given ticking group and category. Functions are grouped by the class of the object
+	 * and by TickFunctionGroup. Settings are applied to the group when it's created, see FTickFunctionGroupSettings.
+	 *
+	 * Registration and removal functions can be called from any thread. Off the game thread, requests are queued and applied
+	 * at the start of the next world tick, returned handle is a deferred one that is valid right away.
+	 */
+	FTickAggregatorFunctionHandle RegisterNativeObject(const UObject* Object, const FAggregatedTickDelegate& Function, const ETickingGroup TickingGroup, ETickAggregatorTickCategory::Type Category, const FTickFunctionGroupId TickFunctionGroup, const FTickFunctionGroupSettings& Settings = FTickFunctionGroupSettings());
 	bool RemoveNativeObject(const FTickAggregatorFunctionHandle& InHandle);
 
+	/**
+	 * Register T::TickFunction to a typed group. Typed groups call the function directly on a raw pointer of the object instead of
+	 * going through a delegate, so object MUST be removed via RemoveNativeObject() before it's destroyed. See TA_REGISTER_TICK_TYPED.
+	 */
+	template<typename T, void(T::*TickFunction)(float)>
+	FTickAggregatorFunctionHandle RegisterTypedNativeObject(T* Object, const ETickingGroup TickingGroup, ETickAggregatorTickCategory::Type Category, const FTickFunctionGroupId TickFunctionGroup)
+	{
+		return RegisterObjectToTypedGroup<TTypedTickFunctionGroup<T, TickFunction>>(Object, TickingGroup, Category, TickFunctionGroup);
+	}
+
+	/**
+	 * Register object to a batch group. BatchTickFunction is called once per frame with all objects of class T registered to
+	 * the same group, instead of once per object. Same as typed groups, object MUST be removed before it's destroyed. See TA_REGISTER_BATCH_TICK.
+	 */
+	template<typename T, void(*BatchTickFunction)(TArrayView<T* const>, float)>
+	FTickAggregatorFunctionHandle RegisterBatchNativeObject(T* Object, const ETickingGroup TickingGroup, ETickAggregatorTickCategory::Type Category, const FTickFunctionGroupId TickFunctionGroup)
+	{
+		return RegisterObjectToTypedGroup<TBatchTickFunctionGroup<T, BatchTickFunction>>(Object, TickingGroup, Category, TickFunctionGroup);
+	}
+
 	UFUNCTION(BlueprintCallable, Category = "Tick Aggregator")
 	bool RegisterBlueprintObject(UObject* Object, const ETickAggregatorTickCategory::Type TickCategory = ETickAggregatorTickCategory::TC_ECHO, const ETickingGroup TickingGroup = TG_PostPhysics);
 
 	UFUNCTION(BlueprintCallable, Category = "Tick Aggregator")
 	bool RemoveBlueprintObject(UObject* Object, const ETickAggregatorTickCategory::Type TickCategory, const ETickingGroup TickingGroup);
 
+	/**
+	 * Register a manager object that receives BlueprintAggregatedBatchTick once per frame with all objects of ObjectClass that are
+	 * registered via RegisterBlueprintBatchObject() with the same category and ticking group. So BP VM is entered once per class
+	 * instead of once per object. Objects must be exactly of ObjectClass, subclasses are batched separately. Manager must implement ITickAggregatorInterface.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Tick Aggregator")
+	bool RegisterBlueprintBatchManager(UObject* Manager, TSubclassOf<UObject> ObjectClass, const ETickAggregatorTickCategory::Type TickCategory = ETickAggregatorTickCategory::TC_ECHO, const ETickingGroup TickingGroup = TG_PostPhysics);
+
+	UFUNCTION(BlueprintCallable, Category = "Tick Aggregator")
+	bool RemoveBlueprintBatchManager(UObject* Manager, TSubclassOf<UObject> ObjectClass, const ETickAggregatorTickCategory::Type TickCategory, const ETickingGroup TickingGroup);
+
+	/** Register object to the batch of it's class, see RegisterBlueprintBatchManager(). Object doesn't need to implement any interface. */
+	UFUNCTION(BlueprintCallable, Category = "Tick Aggregator")
+	bool RegisterBlueprintBatchObject(UObject* Object, const ETickAggregatorTickCategory::Type TickCategory = ETickAggregatorTickCategory::TC_ECHO, const ETickingGroup TickingGroup = TG_PostPhysics);
+
+	UFUNCTION(BlueprintCallable, Category = "Tick Aggregator")
+	bool RemoveBlueprintBatchObject(UObject* Object, const ETickAggregatorTickCategory::Type TickCategory, const ETickingGroup TickingGroup);
+
 	/**
 	 * Register object to the tick function with it's desired tick group.
 	 * - Registration happens next frame.
@@ -100,24 +183,66 @@ public:
 	UFUNCTION()
 	virtual void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
 
+	/** Ticking group of given interface object, component's owner can override it. Returns TG_MAX if object doesn't provide a valid one. */
+	static ETickingGroup GetInterfaceTickingGroup(UObject* Object);
+
+	/** Sweeps objects that are about to be collected from all tick functions, see FAggregatedTickFunction::RemoveUnreachableObjects. */
+	void OnPostReachabilityAnalysis();
+
 	FAggregatedTickFunction* GetTickFunctionByObject(UObject* Object);
 	
 	FAggregatedTickFunction* GetTickFunctionByEnum(ETickingGroup TickingGroup);
 
+	/** Sets the time all aggregated tick functions of this world can take per frame. Zero or less disables the budget. */
+	UFUNCTION(BlueprintCallable, Category = "Tick Aggregator")
+	void SetFrameBudget(float InFrameBudgetMilliseconds);
+
 	UFUNCTION(BlueprintCallable, Exec)
 	void PrintAggregatedTickSubscriberCount();
 
 	UFUNCTION(BlueprintCallable, Exec)
 	void TickAggregatorDumpRegisteredObjects();
 
-	TMap<TSoftClassPtr<UClass>, FTickAggregatorObjectArray> AggregatedObjectTickElements;
-
 	/** Whether aggregator should iterate over all placed actors placed on the map, or should let user handle this logic? */
 	UPROPERTY(Config)
 	bool bAutomaticallyRegisterAllPlacedActorsOnLevel;
 
+	/**
+	 * Time all aggregated tick functions of this world can take per frame, shared across all ticking groups and categories.
+	 * When it's exceeded, groups are deferred to the next frame depending on their ETickFunctionGroupPriority. Zero disables the budget.
+	 */
+	UPROPERTY(Config)
+	float FrameBudgetMilliseconds;
+
+	/** Time that can be spent per frame registering actors of streamed in levels. Zero or less registers whole level in the frame it's added. */
+	UPROPERTY(Config)
+	float LevelRegistrationBudgetMilliseconds;
+
+	/** Shared by all aggregated tick functions below. */
+	FTickAggregatorFrameBudget FrameBudget;
+	FTickAggregatorViewLocations ViewLocations;
+
+	/** Every object registered through ITickAggregatorInterface, see FTickAggregatorObjectRegistration. Game thread only. */
+	TMap<FObjectKey, FTickAggregatorObjectRegistration> RegisteredObjects;
+
+	/** Registered objects by their level, so they can be removed when level is unloaded without iterating all of it's actors. */
+	TMap<FObjectKey, TSet<FObjectKey>> LevelObjects;
+
+	/** Streamed in levels that actors of are being registered, see ProcessLevelRegistrationJobs(). */
+	TArray<FTickAggregatorLevelRegistrationJob> LevelRegistrationJobs;
+
+	/** Whether a class implements ITickAggregatorInterface, so streamed levels don't query interfaces of every actor. */
+	TMap<FObjectKey, bool> InterfaceClassCache;
+
+	/** Registrations requested during this frame, see FlushPendingRegistrations(). */
+	TArray<FTickAggregatorPendingObjectRegistration> PendingRegistrations;
+
 	FOnActorSpawned::FDelegate OnActorSpawnedHandle;
 
+	FDelegateHandle PostReachabilityAnalysisHandle;
+
+	FDelegateHandle WorldTickStartHandle;
+
 	/** Any item that needs to be executed before physics simulation starts. */
 	FAggregatedTickFunction TickFunction_PrePhysics = FAggregatedTickFunction(TG_PrePhysics);
 
@@ -138,5 +263,83 @@ public:
 
 	/** Catchall for anything demoted to the end. */
 	FAggregatedTickFunction TickFunction_LastDemotable = FAggregatedTickFunction(TG_LastDemotable);
+
+protected:
+
+	template<typename GroupType>
+	FTickAggregatorFunctionHandle RegisterObjectToTypedGroup(typename GroupType::ObjectType* Object, const ETickingGroup TickingGroup, ETickAggregatorTickCategory::Type Category, const FTickFunctionGroupId TickFunctionGroup)
+	{
+		if (!IsValid(Object) || Category == ETickAggregatorTickCategory::TC_MAX || TickingGroup == TG_MAX)
+		{
+			return Intax::TA::MakeInvalidFunctionHandle();
+		}
+
+		FAggregatedTickFunction* FoundTickFunction = GetTickFunctionByEnum(TickingGroup);
+		if (!ensure(FoundTickFunction))
+		{
+			return Intax::TA::MakeInvalidFunctionHandle();
+		}
+
+		if (!IsInGameThread())
+		{
+			using ObjectType = typename GroupType::ObjectType;
+			TWeakObjectPtr<ObjectType> WeakObject = Object;
+			return FoundTickFunction->EnqueueRegisterRequest(Category, [WeakObject, Category, TickFunctionGroup](FAggregatedTickFunction& InTickFunction)
+			{
+				ObjectType* PendingObject = WeakObject.Get();
+				return PendingObject ? InTickFunction.RegisterTypedNativeFunction<GroupType>(PendingObject, Category, TickFunctionGroup) : Intax::TA::MakeInvalidFunctionHandle();
+			});
+		}
+
+		return FoundTickFunction->RegisterTypedNativeFunction<GroupType>(Object, Category, TickFunctionGroup);
+	}
+
+	/** Adds a record for given interface object, returns false if it's already registered or pending. */
+	bool AddRegistrationRecord(UObject* Object);
+
+	/** Removes the record of given object, and it from the objects of it's level. Returns false if object isn't registered. */
+	bool RemoveRegistrationRecord(const FObjectKey& Object, FTickAggregatorObjectRegistration* OutRegistration = nullptr);
+
+	void RemoveFromLevelObjects(const FObjectKey& Object, const FObjectKey& Level);
+
+	/** Cached Implements<UTickAggregatorInterface>() of given class. */
+	bool DoesClassImplementInterface(const UClass* Class);
+
+	/** Registers interface actors of streamed in levels until LevelRegistrationBudgetMilliseconds is exceeded, continues next frame. */
+	void ProcessLevelRegistrationJobs();
+
+	/** Adds a record and queues given interface object to be registered at the start of next frame. */
+	bool AddPendingRegistration(UObject* Object, bool bUnordered, ETickingGroup TickingGroup = TG_MAX, ETickAggregatorTickCategory::Type Category = ETickAggregatorTickCategory::TC_MAX);
+
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/**
+	 * Registers all objects queued during last frame at once, instead of a timer per object. Ticking groups and categories are
+	 * resolved first, then registrations are applied sorted by tick function, category and class.
+	 */
+	void FlushPendingRegistrations();
+
+	void BindRegisteredActorDestroyed(AActor* Actor);
+
+	/** Registers placed actors of given level that want to be registered automatically, from it's manifest if it has one. Returns registered actor count. */
+	int32 RegisterPlacedActors(ULevel* Level);
+
+	/** Registers given actor and it's components with the ticking groups and categories recorded in the manifest. */
+	bool RegisterManifestActor(const FTickAggregatorManifestActor& Entry, bool bUnordered);
+
+	/** Returns true if given object still waits to be registered, removals in the meantime cancel the registration. */
+	bool IsRegistrationPending(UObject* Object) const;
+
+	void ApplyRegistration(UObject* Object, ETickingGroup TickingGroup, ETickAggregatorTickCategory::Type Category);
+
+	/** Removes given object and the components it owns with a single lookup each, without querying any of them. */
+	void RemoveRegisteredObject(UObject* Object, bool bDestroyOnNextTick);
+
+	/** Object can be null if it's already collected. */
+	void UnregisterObject(UObject* Object, const FTickAggregatorObjectRegistration& Registration, bool bDestroyOnNextTick);
+
+	/** Queues given interface object or actor request to be called on game thread, used when registration functions are called from other threads. */
+	template<typename ObjectType>
+	void EnqueueGameThreadRequest(ObjectType* Object, void(UTickAggregatorWorldSubsystem::*Request)(ObjectType*));
 	
 };
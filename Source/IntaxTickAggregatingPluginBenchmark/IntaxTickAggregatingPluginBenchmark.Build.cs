@@ -0,0 +1,22 @@
+// Copyright INTAX Interactive, all rights reserved.
+
+using UnrealBuildTool;
+
+public class IntaxTickAggregatingPluginBenchmark : ModuleRules
+{
+	public IntaxTickAggregatingPluginBenchmark(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// benchmark commandlet and it's actors, editor only so they never ship with the runtime module.
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"IntaxTickAggregatingPlugin",
+			}
+			);
+	}
+}
@@ -0,0 +1,5 @@
+﻿// Copyright INTAX Interactive, all rights reserved.
+
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, IntaxTickAggregatingPluginBenchmark)
@@ -0,0 +1,388 @@
+﻿// Copyright INTAX Interactive, all rights reserved.
+
+#include "TickAggregatorBenchmark.h"
+#include "TickAggregatorWorldSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/FileHelper.h"
+
+ATickAggregatorBenchmarkActor::ATickAggregatorBenchmarkActor()
+{
+	// engine tick is only enabled by the EngineTick mode.
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+UTickAggregatorBenchmarkComponent::UTickAggregatorBenchmarkComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void ATickAggregatorBenchmarkActor::RegisterIntervalTick(const FTickFunctionGroupId GroupId, const float Interval)
+{
+	TA_REGISTER_TICK_INTERVAL(Handle, this, BenchmarkTick, TG_PostPhysics, TC_ECHO, GroupId, Interval);
+}
+
+void UTickAggregatorBenchmarkComponent::RegisterIntervalTick(const FTickFunctionGroupId GroupId, const float Interval)
+{
+	TA_REGISTER_TICK_INTERVAL(Handle, this, BenchmarkTick, TG_PostPhysics, TC_ECHO, GroupId, Interval);
+}
+
+namespace Intax::TA::Private
+{
+	struct FBenchmarkConfig
+	{
+		TArray<int32> Counts = { 1000, 10000, 100000 };
+		TArray<ETickAggregatorBenchmarkMode> Modes;
+		int32 Classes = 4;
+		int32 Groups = 1;
+		int32 Frames = 300;
+		int32 Warmup = 30;
+		bool bComponents = false;
+		FString CsvPath;
+	};
+
+	struct FBenchmarkResult
+	{
+		ETickAggregatorBenchmarkMode Mode = ETickAggregatorBenchmarkMode::Baseline;
+		int32 Count = 0;
+		double MeanMs = 0.0;
+		double MedianMs = 0.0;
+		double P95Ms = 0.0;
+		double P99Ms = 0.0;
+		double MaxMs = 0.0;
+		/** Frame time on top of baseline divided by count of ticked objects. */
+		double NanosecondsPerTick = 0.0;
+	};
+
+	static const TCHAR* LexBenchmarkMode(const ETickAggregatorBenchmarkMode Mode)
+	{
+		switch (Mode)
+		{
+		case ETickAggregatorBenchmarkMode::Baseline:			return TEXT("Baseline");
+		case ETickAggregatorBenchmarkMode::EngineTick:			return TEXT("EngineTick");
+		case ETickAggregatorBenchmarkMode::Aggregated:			return TEXT("Aggregated");
+		case ETickAggregatorBenchmarkMode::AggregatedUnordered:	return TEXT("AggregatedUnordered");
+		case ETickAggregatorBenchmarkMode::AggregatedInterval:	return TEXT("AggregatedInterval");
+		case ETickAggregatorBenchmarkMode::Interface:			return TEXT("Interface");
+		case ETickAggregatorBenchmarkMode::InterfaceUnordered:	return TEXT("InterfaceUnordered");
+		default:												return TEXT("Unknown");
+		}
+	}
+
+	static FBenchmarkConfig ParseBenchmarkConfig(const FString& Params)
+	{
+		FBenchmarkConfig Config;
+
+		FString CountsString;
+		if (FParse::Value(*Params, TEXT("Counts="), CountsString, false))
+		{
+			TArray<FString> CountStrings;
+			CountsString.ParseIntoArray(CountStrings, TEXT(","));
+
+			Config.Counts.Reset();
+			for (const FString& CountString : CountStrings)
+			{
+				const int32 Count = FCString::Atoi(*CountString);
+				if (Count > 0)
+				{
+					Config.Counts.Add(Count);
+				}
+			}
+		}
+
+		FString ModesString;
+		if (FParse::Value(*Params, TEXT("Modes="), ModesString, false))
+		{
+			TArray<FString> ModeStrings;
+			ModesString.ParseIntoArray(ModeStrings, TEXT(","));
+			for (const FString& ModeString : ModeStrings)
+			{
+				for (uint8 ModeIndex = static_cast<uint8>(ETickAggregatorBenchmarkMode::EngineTick); ModeIndex <= static_cast<uint8>(ETickAggregatorBenchmarkMode::InterfaceUnordered); ++ModeIndex)
+				{
+					const ETickAggregatorBenchmarkMode Mode = static_cast<ETickAggregatorBenchmarkMode>(ModeIndex);
+					if (ModeString.Equals(LexBenchmarkMode(Mode), ESearchCase::IgnoreCase))
+					{
+						Config.Modes.AddUnique(Mode);
+					}
+				}
+			}
+		}
+
+		if (Config.Modes.IsEmpty())
+		{
+			Config.Modes = { ETickAggregatorBenchmarkMode::EngineTick, ETickAggregatorBenchmarkMode::Aggregated, ETickAggregatorBenchmarkMode::AggregatedUnordered,
+				ETickAggregatorBenchmarkMode::AggregatedInterval, ETickAggregatorBenchmarkMode::Interface, ETickAggregatorBenchmarkMode::InterfaceUnordered };
+		}
+
+		FParse::Value(*Params, TEXT("Classes="), Config.Classes);
+		FParse::Value(*Params, TEXT("Groups="), Config.Groups);
+		FParse::Value(*Params, TEXT("Frames="), Config.Frames);
+		FParse::Value(*Params, TEXT("Warmup="), Config.Warmup);
+		FParse::Value(*Params, TEXT("Csv="), Config.CsvPath);
+		Config.bComponents = FParse::Param(*Params, TEXT("Components"));
+
+		Config.Classes = FMath::Clamp(Config.Classes, 1, 4);
+		Config.Groups = FMath::Max(Config.Groups, 1);
+		Config.Frames = FMath::Max(Config.Frames, 1);
+		Config.Warmup = FMath::Max(Config.Warmup, 0);
+		return Config;
+	}
+
+	/** Headless game world that is ticked manually, same as the engine loop would. */
+	class FBenchmarkWorld
+	{
+	public:
+
+		FBenchmarkWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("TickAggregatorBenchmark"));
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+
+			// there is no game mode to start the play in a commandlet, do what it would do.
+			if (!World->HasBegunPlay())
+			{
+				World->GetWorldSettings()->NotifyBeginPlay();
+			}
+
+			Subsystem = World->GetSubsystem<UTickAggregatorWorldSubsystem>();
+		}
+
+		~FBenchmarkWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+
+		/** Ticks one frame and returns it's duration in cycles. */
+		uint64 TickFrame(const float DeltaTime)
+		{
+			++GFrameCounter;
+
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			World->Tick(LEVELTICK_All, DeltaTime);
+			return FPlatformTime::Cycles64() - StartCycles;
+		}
+
+		UWorld* World = nullptr;
+		UTickAggregatorWorldSubsystem* Subsystem = nullptr;
+	};
+
+	template<typename ObjectType>
+	static void RegisterBenchmarkObject(UTickAggregatorWorldSubsystem& Subsystem, ObjectType& Object, const ETickAggregatorBenchmarkMode Mode, const FTickFunctionGroupId GroupId, const float DeltaTime)
+	{
+		FAggregatedTickDelegate Delegate;
+		Delegate.BindUObject(&Object, &ObjectType::BenchmarkTick);
+
+		switch (Mode)
+		{
+		case ETickAggregatorBenchmarkMode::Aggregated:
+			Object.Handle = Subsystem.RegisterNativeObject(&Object, Delegate, TG_PostPhysics, ETickAggregatorTickCategory::TC_ECHO, GroupId);
+			break;
+		case ETickAggregatorBenchmarkMode::AggregatedUnordered:
+			Object.Handle = Subsystem.RegisterNativeObject(&Object, Delegate, TG_PostPhysics, ETickAggregatorTickCategory::TC_UNORDERED, GroupId);
+			break;
+		case ETickAggregatorBenchmarkMode::AggregatedInterval:
+			Object.RegisterIntervalTick(GroupId, DeltaTime);
+			break;
+		case ETickAggregatorBenchmarkMode::Interface:
+			Subsystem.RegisterObject(&Object);
+			break;
+		case ETickAggregatorBenchmarkMode::InterfaceUnordered:
+			Subsystem.RegisterUnorderedObject(&Object);
+			break;
+		default:
+			break;
+		}
+	}
+
+	template<typename ObjectType>
+	static void RemoveBenchmarkObject(UTickAggregatorWorldSubsystem& Subsystem, ObjectType& Object, const ETickAggregatorBenchmarkMode Mode)
+	{
+		switch (Mode)
+		{
+		case ETickAggregatorBenchmarkMode::Aggregated:
+		case ETickAggregatorBenchmarkMode::AggregatedUnordered:
+		case ETickAggregatorBenchmarkMode::AggregatedInterval:
+			Subsystem.RemoveNativeObject(Object.Handle);
+			break;
+		case ETickAggregatorBenchmarkMode::Interface:
+			Subsystem.RemoveObject(&Object);
+			break;
+		case ETickAggregatorBenchmarkMode::InterfaceUnordered:
+			Subsystem.RemoveUnorderedObject(&Object);
+			break;
+		default:
+			break;
+		}
+	}
+
+	static FBenchmarkResult RunBenchmarkScenario(FBenchmarkWorld& BenchmarkWorld, const FBenchmarkConfig& Config, const ETickAggregatorBenchmarkMode Mode, const int32 Count)
+	{
+		static const TSubclassOf<ATickAggregatorBenchmarkActor> ActorClasses[] = {
+			ATickAggregatorBenchmarkActor_Alpha::StaticClass(), ATickAggregatorBenchmarkActor_Bravo::StaticClass(),
+			ATickAggregatorBenchmarkActor_Charlie::StaticClass(), ATickAggregatorBenchmarkActor_Delta::StaticClass()
+		};
+
+		constexpr float DeltaTime = 1.f / 60.f;
+		UWorld* World = BenchmarkWorld.World;
+		UTickAggregatorWorldSubsystem& Subsystem = *BenchmarkWorld.Subsystem;
+
+		// mode of a group is fixed when it's created, so interval groups can't share their names with the every frame groups.
+		const TCHAR* GroupName = Mode == ETickAggregatorBenchmarkMode::AggregatedInterval ? TEXT("BenchmarkInterval") : TEXT("Benchmark");
+
+		TArray<FTickFunctionGroupId> GroupIds;
+		for (int32 GroupIndex = 0; GroupIndex < Config.Groups; ++GroupIndex)
+		{
+			GroupIds.Add(FTickFunctionGroupId(FName(GroupName, GroupIndex + 1)));
+		}
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		TArray<ATickAggregatorBenchmarkActor*> Actors;
+		Actors.Reserve(Count);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			// objects of the same class are spawned interleaved on purpose, so ordered paths can't benefit from spawn order.
+			ATickAggregatorBenchmarkActor* Actor = World->SpawnActor<ATickAggregatorBenchmarkActor>(ActorClasses[Index % Config.Classes], SpawnParameters);
+			Actors.Add(Actor);
+
+			const FTickFunctionGroupId GroupId = GroupIds[(Index / Config.Classes) % Config.Groups];
+			if (Config.bComponents)
+			{
+				UTickAggregatorBenchmarkComponent* Component = NewObject<UTickAggregatorBenchmarkComponent>(Actor);
+				Component->RegisterComponent();
+				if (Mode == ETickAggregatorBenchmarkMode::EngineTick)
+				{
+					Component->SetComponentTickEnabled(true);
+				}
+				RegisterBenchmarkObject(Subsystem, *Component, Mode, GroupId, DeltaTime);
+			}
+			else
+			{
+				if (Mode == ETickAggregatorBenchmarkMode::EngineTick)
+				{
+					Actor->SetActorTickEnabled(true);
+				}
+				RegisterBenchmarkObject(Subsystem, *Actor, Mode, GroupId, DeltaTime);
+			}
+		}
+
+		// interface registrations are applied on next frame, warmup covers them.
+		for (int32 FrameIndex = 0; FrameIndex < Config.Warmup + 1; ++FrameIndex)
+		{
+			BenchmarkWorld.TickFrame(DeltaTime);
+		}
+
+		TArray<double> FrameTimesMs;
+		FrameTimesMs.Reserve(Config.Frames);
+		for (int32 FrameIndex = 0; FrameIndex < Config.Frames; ++FrameIndex)
+		{
+			FrameTimesMs.Add(FPlatformTime::ToMilliseconds64(BenchmarkWorld.TickFrame(DeltaTime)));
+		}
+
+		for (ATickAggregatorBenchmarkActor* Actor : Actors)
+		{
+			if (Config.bComponents)
+			{
+				if (UTickAggregatorBenchmarkComponent* Component = Actor->FindComponentByClass<UTickAggregatorBenchmarkComponent>())
+				{
+					RemoveBenchmarkObject(Subsystem, *Component, Mode);
+				}
+			}
+			else
+			{
+				RemoveBenchmarkObject(Subsystem, *Actor, Mode);
+			}
+			Actor->Destroy();
+		}
+
+		// let removals be applied before the next scenario.
+		BenchmarkWorld.TickFrame(DeltaTime);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+		FrameTimesMs.Sort();
+		const auto Percentile = [&FrameTimesMs](const double Fraction)
+		{
+			return FrameTimesMs[FMath::Clamp(static_cast<int32>(Fraction * FrameTimesMs.Num()), 0, FrameTimesMs.Num() - 1)];
+		};
+
+		FBenchmarkResult Result;
+		Result.Mode = Mode;
+		Result.Count = Count;
+		for (const double FrameTimeMs : FrameTimesMs)
+		{
+			Result.MeanMs += FrameTimeMs;
+		}
+		Result.MeanMs /= FrameTimesMs.Num();
+		Result.MedianMs = Percentile(0.5);
+		Result.P95Ms = Percentile(0.95);
+		Result.P99Ms = Percentile(0.99);
+		Result.MaxMs = FrameTimesMs.Last();
+		return Result;
+	}
+}
+
+UTickAggregatorBenchmarkCommandlet::UTickAggregatorBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTickAggregatorBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace Intax::TA::Private;
+
+	const FBenchmarkConfig Config = ParseBenchmarkConfig(Params);
+
+	FBenchmarkWorld BenchmarkWorld;
+	if (!BenchmarkWorld.Subsystem)
+	{
+		TA_LOG(Error, "Tick aggregator subsystem was not created for benchmark world.");
+		return 1;
+	}
+
+	TA_LOG(Display, "Tick aggregator benchmark: %d classes, %d groups, %d frames, ticking %s.", Config.Classes, Config.Groups, Config.Frames, Config.bComponents ? TEXT("components") : TEXT("actors"));
+
+	TArray<FBenchmarkResult> Results;
+	for (const int32 Count : Config.Counts)
+	{
+		const FBenchmarkResult Baseline = RunBenchmarkScenario(BenchmarkWorld, Config, ETickAggregatorBenchmarkMode::Baseline, Count);
+		Results.Add(Baseline);
+
+		for (const ETickAggregatorBenchmarkMode Mode : Config.Modes)
+		{
+			FBenchmarkResult Result = RunBenchmarkScenario(BenchmarkWorld, Config, Mode, Count);
+			Result.NanosecondsPerTick = FMath::Max(Result.MeanMs - Baseline.MeanMs, 0.0) * 1000000.0 / Count;
+			Results.Add(Result);
+		}
+	}
+
+	TArray<FString> CsvLines = { TEXT("Mode,Count,MeanMs,MedianMs,P95Ms,P99Ms,MaxMs,NsPerTick") };
+	for (const FBenchmarkResult& Result : Results)
+	{
+		TA_LOG(Display, "%-20s %7d objects | mean %8.3f ms | p50 %8.3f ms | p95 %8.3f ms | p99 %8.3f ms | max %8.3f ms | %8.1f ns per tick",
+			LexBenchmarkMode(Result.Mode), Result.Count, Result.MeanMs, Result.MedianMs, Result.P95Ms, Result.P99Ms, Result.MaxMs, Result.NanosecondsPerTick);
+
+		CsvLines.Add(FString::Printf(TEXT("%s,%d,%f,%f,%f,%f,%f,%f"), LexBenchmarkMode(Result.Mode), Result.Count,
+			Result.MeanMs, Result.MedianMs, Result.P95Ms, Result.P99Ms, Result.MaxMs, Result.NanosecondsPerTick));
+	}
+
+	if (!Config.CsvPath.IsEmpty() && !FFileHelper::SaveStringArrayToFile(CsvLines, *Config.CsvPath))
+	{
+		TA_LOG(Error, "Could not write benchmark results to %s.", *Config.CsvPath);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,113 @@
+﻿// Copyright INTAX Interactive, all rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TickAggregatorInterface.h"
+#include "Commandlets/Commandlet.h"
+#include "Components/ActorComponent.h"
+#include "GameFramework/Actor.h"
+#include "TickAggregatorBenchmark.generated.h"
+
+/** How the population of a benchmark scenario is ticked. */
+enum class ETickAggregatorBenchmarkMode : uint8
+{
+	/** Nothing ticks, measures the frame cost of the world itself. Other modes are measured against this. */
+	Baseline,
+	/** PrimaryActorTick / PrimaryComponentTick, every object goes through QueueTicks of the engine's tick manager. */
+	EngineTick,
+	/** RegisterNativeObject() to an ordered category. */
+	Aggregated,
+	/** RegisterNativeObject() to TC_UNORDERED. */
+	AggregatedUnordered,
+	/** TA_REGISTER_TICK_INTERVAL with an interval of one frame, so every function still ticks every frame. */
+	AggregatedInterval,
+	/** RegisterObject() through ITickAggregatorInterface. */
+	Interface,
+	/** RegisterUnorderedObject() through ITickAggregatorInterface. */
+	InterfaceUnordered,
+};
+
+/** Does the same tiny amount of work no matter which path it's ticked through, so only the dispatch cost differs between modes. */
+UCLASS(Abstract, NotPlaceable, Transient)
+class ATickAggregatorBenchmarkActor : public AActor, public ITickAggregatorInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	ATickAggregatorBenchmarkActor();
+
+	virtual void Tick(float DeltaSeconds) override { BenchmarkTick(DeltaSeconds); }
+	virtual void AggregatedTick(float DeltaTime) override { BenchmarkTick(DeltaTime); }
+
+	void BenchmarkTick(float DeltaTime) { Accumulator = Accumulator * 0.5f + DeltaTime; }
+
+	void RegisterIntervalTick(const FTickFunctionGroupId GroupId, const float Interval);
+
+	FTickAggregatorFunctionHandle Handle;
+
+	float Accumulator = 0.f;
+};
+
+/** Benchmark populations are split to these classes, so class count of a scenario can be configured up to 4. */
+
+UCLASS(NotPlaceable, Transient)
+class ATickAggregatorBenchmarkActor_Alpha : public ATickAggregatorBenchmarkActor { GENERATED_BODY() };
+
+UCLASS(NotPlaceable, Transient)
+class ATickAggregatorBenchmarkActor_Bravo : public ATickAggregatorBenchmarkActor { GENERATED_BODY() };
+
+UCLASS(NotPlaceable, Transient)
+class ATickAggregatorBenchmarkActor_Charlie : public ATickAggregatorBenchmarkActor { GENERATED_BODY() };
+
+UCLASS(NotPlaceable, Transient)
+class ATickAggregatorBenchmarkActor_Delta : public ATickAggregatorBenchmarkActor { GENERATED_BODY() };
+
+/** Same as ATickAggregatorBenchmarkActor, used when scenario ticks components instead of actors. */
+UCLASS(Transient)
+class UTickAggregatorBenchmarkComponent : public UActorComponent, public ITickAggregatorInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	UTickAggregatorBenchmarkComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override { BenchmarkTick(DeltaTime); }
+	virtual void AggregatedTick(float DeltaTime) override { BenchmarkTick(DeltaTime); }
+
+	void BenchmarkTick(float DeltaTime) { Accumulator = Accumulator * 0.5f + DeltaTime; }
+
+	void RegisterIntervalTick(const FTickFunctionGroupId GroupId, const float Interval);
+
+	FTickAggregatorFunctionHandle Handle;
+
+	float Accumulator = 0.f;
+};
+
+/**
+ * Measures the dispatch overhead of each tick path in a headless game world, so the cost of aggregation can be compared
+ * against engine ticks and regressions can be caught.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=TickAggregatorBenchmark -nullrhi -unattended
+ *   -Counts=1000,10000,100000  population sizes to measure.
+ *   -Classes=4                 count of classes population is split to, 1 to 4.
+ *   -Groups=1                  count of tick function groups per class for aggregated modes.
+ *   -Frames=300                measured frames per scenario.
+ *   -Warmup=30                 frames ticked before measuring.
+ *   -Components                tick one component per actor instead of the actors.
+ *   -Modes=Aggregated,...      only run given modes, baseline always runs.
+ *   -Csv=<Path>                also write the results to given csv file.
+ */
+UCLASS()
+class UTickAggregatorBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UTickAggregatorBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};